@@ -20,10 +20,12 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/queue.h"
 #include "common/util.h"
 
@@ -81,8 +83,15 @@ SeekableAudioStream *SeekableAudioStream::openStreamFile(const Common::String &b
 
 	delete fileHandle;
 
-	if (stream == NULL)
+	if (stream == NULL) {
 		debug(1, "SeekableAudioStream::openStreamFile: Could not open compressed AudioFile %s", basename.c_str());
+		return NULL;
+	}
+
+	// Keep decoding compressed audio off the mixer thread, if requested
+	const int decodeAhead = ConfMan.getInt("audio_decode_ahead");
+	if (decodeAhead > 0)
+		stream = makeDecodeAheadAudioStream(stream, decodeAhead);
 
 	return stream;
 }
@@ -466,6 +475,405 @@ AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp
 	return new LimitingAudioStream(parentStream, length, disposeAfterUse);
 }
 
+#pragma mark -
+#pragma mark --- Decode ahead stream ---
+#pragma mark -
+
+namespace {
+
+enum {
+	/** Interval of the decoder's timer callback, in milliseconds */
+	kDecodeAheadInterval = 10,
+
+	/**
+	 * Milliseconds of audio decoded per stream and callback. This is twice
+	 * what plays meanwhile, so that a drained buffer fills up again.
+	 */
+	kDecodeAheadChunkLength = 2 * kDecodeAheadInterval,
+
+	/**
+	 * Milliseconds a callback may spend decoding. The timer thread also runs
+	 * the engines' timers, so once this is used up, the remaining streams
+	 * are left to the next callback.
+	 */
+	kDecodeAheadBudget = 4
+};
+
+/**
+ * The decoding state of a DecodeAheadAudioStream. It is kept apart from the
+ * stream, so that the timer callback can finish decoding a chunk after the
+ * stream got deleted, instead of the deleting thread having to wait for it.
+ *
+ * Only the decoder, which holds _decodeMutex, touches the parent stream.
+ * The reading side only ever takes the short-lived _bufferMutex.
+ */
+class DecodeAheadBuffer {
+public:
+	DecodeAheadBuffer(AudioStream *parentStream, SeekableAudioStream *seekableParent, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse);
+	~DecodeAheadBuffer();
+
+	/**
+	 * Perform a pending seek, and decode one chunk into the free part of the
+	 * buffer. Does nothing else if the buffer is full or the parent has
+	 * ended.
+	 */
+	void decodeChunk();
+
+	/** Decode until the buffer is full or the parent has ended */
+	void fill();
+
+	/**
+	 * Take samples out of the buffer. Never waits for decoding: if the
+	 * buffer runs empty before the parent ended, the rest is silence.
+	 */
+	int read(int16 *buffer, int numSamples);
+
+	bool endOfData() const;
+	bool endOfStream() const;
+
+	/**
+	 * Discard all decoded samples, and have the decoder seek the parent
+	 * before it decodes the next chunk.
+	 */
+	void requestSeek(const Timestamp &where);
+
+	/** Serializes access to the parent stream */
+	Common::Mutex _decodeMutex;
+
+	/** Set while the timer callback decodes. Guarded by the stream list mutex. */
+	bool _busy;
+	/** Set when the stream is gone while _busy. Guarded by the stream list mutex. */
+	bool _released;
+
+private:
+	/** Update the end state of the parent. Must be called with _bufferMutex held. */
+	void updateParentState();
+
+	Common::DisposablePtr<AudioStream> _parentStream;
+	SeekableAudioStream *const _seekableParent;
+	const bool _isStereo;
+	uint _chunkSize;
+
+	/** Protects the buffer state, the parent's end state and the seek request */
+	mutable Common::Mutex _bufferMutex;
+	int16 *_buffer;
+	uint _bufferSize;
+	uint _readPos;
+	uint _fill;
+	bool _parentEndOfData;
+	bool _parentEndOfStream;
+
+	bool _seekPending;
+	Timestamp _seekTarget;
+	/** Bumped by every seek, so that chunks decoded before it are dropped */
+	uint32 _seekCount;
+};
+
+DecodeAheadBuffer::DecodeAheadBuffer(AudioStream *parentStream, SeekableAudioStream *seekableParent, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse)
+	: _busy(false), _released(false), _parentStream(parentStream, disposeAfterUse), _seekableParent(seekableParent),
+	  _isStereo(parentStream->isStereo()), _readPos(0), _fill(0), _parentEndOfData(parentStream->endOfData()),
+	  _parentEndOfStream(parentStream->endOfStream()), _seekPending(false), _seekCount(0) {
+	const uint channels = _isStereo ? 2 : 1;
+	_chunkSize = MAX<uint>((uint64)parentStream->getRate() * kDecodeAheadChunkLength / 1000, 1) * channels;
+	_bufferSize = MAX<uint>((uint64)parentStream->getRate() * lookahead / 1000 * channels, _chunkSize);
+	_buffer = new int16[_bufferSize];
+}
+
+DecodeAheadBuffer::~DecodeAheadBuffer() {
+	delete[] _buffer;
+}
+
+void DecodeAheadBuffer::updateParentState() {
+	_parentEndOfData = _parentStream->endOfData();
+	_parentEndOfStream = _parentStream->endOfStream();
+}
+
+void DecodeAheadBuffer::decodeChunk() {
+	Common::StackLock decodeLock(_decodeMutex);
+
+	bool seek = false;
+	Timestamp target;
+	{
+		Common::StackLock lock(_bufferMutex);
+		if (_seekPending) {
+			seek = true;
+			target = _seekTarget;
+			_seekPending = false;
+		}
+	}
+
+	if (seek)
+		_seekableParent->seek(target);
+
+	uint writePos, space, seekCount;
+	{
+		Common::StackLock lock(_bufferMutex);
+		// Another seek came in meanwhile, leave it to the next chunk
+		if (_seekPending)
+			return;
+		if (seek)
+			updateParentState();
+		if (_parentEndOfData)
+			return;
+
+		// Only the decoder writes to the free part of the buffer, so it
+		// can be filled without holding the lock
+		writePos = (_readPos + _fill) % _bufferSize;
+		space = MIN(_bufferSize - _fill, _bufferSize - writePos);
+		if (_isStereo)
+			space &= ~1;
+		if (space == 0)
+			return;
+		seekCount = _seekCount;
+	}
+
+	const int samples = _parentStream->readBuffer(_buffer + writePos, MIN(space, _chunkSize));
+
+	Common::StackLock lock(_bufferMutex);
+	if (seekCount != _seekCount)
+		return;
+	if (samples > 0)
+		_fill += samples;
+	updateParentState();
+}
+
+void DecodeAheadBuffer::fill() {
+	Common::StackLock decodeLock(_decodeMutex);
+
+	for (;;) {
+		uint fill;
+		{
+			Common::StackLock lock(_bufferMutex);
+			if (_parentEndOfData)
+				return;
+			fill = _fill;
+		}
+
+		decodeChunk();
+
+		Common::StackLock lock(_bufferMutex);
+		if (_fill == fill)
+			return;
+	}
+}
+
+int DecodeAheadBuffer::read(int16 *buffer, int numSamples) {
+	Common::StackLock lock(_bufferMutex);
+
+	int samples = 0;
+	while (samples < numSamples && _fill > 0) {
+		const uint len = MIN<uint>(MIN<uint>(numSamples - samples, _fill), _bufferSize - _readPos);
+		memcpy(buffer + samples, _buffer + _readPos, len * sizeof(int16));
+		samples += len;
+		_fill -= len;
+		_readPos = (_readPos + len) % _bufferSize;
+	}
+
+	// A short read would be taken for the end of the stream, or play as a
+	// gap. Only return one when the parent really ended.
+	if (samples < numSamples && !_parentEndOfData) {
+		memset(buffer + samples, 0, (numSamples - samples) * sizeof(int16));
+		samples = numSamples;
+	}
+	return samples;
+}
+
+bool DecodeAheadBuffer::endOfData() const {
+	Common::StackLock lock(_bufferMutex);
+	return _fill == 0 && _parentEndOfData;
+}
+
+bool DecodeAheadBuffer::endOfStream() const {
+	Common::StackLock lock(_bufferMutex);
+	return _fill == 0 && _parentEndOfStream;
+}
+
+void DecodeAheadBuffer::requestSeek(const Timestamp &where) {
+	Common::StackLock lock(_bufferMutex);
+	_seekPending = true;
+	_seekTarget = where;
+	++_seekCount;
+	_readPos = _fill = 0;
+	_parentEndOfData = _parentEndOfStream = false;
+}
+
+/** Guards the list of buffers to decode and the timer state */
+Common::Mutex *g_decodeAheadMutex = nullptr;
+Common::Array<DecodeAheadBuffer *> *g_decodeAheadBuffers = nullptr;
+/** The buffer the next timer callback starts with */
+uint g_decodeAheadNext = 0;
+bool g_decodeAheadTimerInstalled = false;
+
+/**
+ * Decode one chunk for each stream, until kDecodeAheadBudget is used up.
+ * Every callback starts with the stream after the last one decoded, so
+ * that all of them get their turn. The list lock is not held while
+ * decoding, so that streams can be created and deleted meanwhile.
+ */
+void decodeAheadTimerProc(void *refCon) {
+	const uint32 start = g_system->getMillis();
+
+	uint count;
+	{
+		Common::StackLock lock(*g_decodeAheadMutex);
+		count = g_decodeAheadBuffers->size();
+	}
+
+	for (uint i = 0; i < count; ++i) {
+		DecodeAheadBuffer *buffer;
+		{
+			Common::StackLock lock(*g_decodeAheadMutex);
+			if (g_decodeAheadBuffers->empty())
+				break;
+			g_decodeAheadNext %= g_decodeAheadBuffers->size();
+			buffer = (*g_decodeAheadBuffers)[g_decodeAheadNext++];
+			buffer->_busy = true;
+		}
+
+		buffer->decodeChunk();
+
+		bool released;
+		{
+			Common::StackLock lock(*g_decodeAheadMutex);
+			buffer->_busy = false;
+			released = buffer->_released;
+		}
+		if (released)
+			delete buffer;
+
+		if (g_system->getMillis() - start >= kDecodeAheadBudget)
+			break;
+	}
+}
+
+} // End of anonymous namespace
+
+void initDecodeAheadStreams() {
+	if (!g_decodeAheadMutex) {
+		g_decodeAheadMutex = new Common::Mutex();
+		g_decodeAheadBuffers = new Common::Array<DecodeAheadBuffer *>();
+	}
+}
+
+void deinitDecodeAheadStreams() {
+	if (!g_decodeAheadMutex)
+		return;
+
+	// Removing the timer waits for a running callback to finish
+	if (g_decodeAheadTimerInstalled && g_system->getTimerManager())
+		g_system->getTimerManager()->removeTimerProc(&decodeAheadTimerProc);
+	g_decodeAheadTimerInstalled = false;
+
+	// Streams which are still around keep using the list
+	if (g_decodeAheadBuffers->empty()) {
+		delete g_decodeAheadBuffers;
+		g_decodeAheadBuffers = nullptr;
+		delete g_decodeAheadMutex;
+		g_decodeAheadMutex = nullptr;
+	}
+}
+
+/**
+ * An AudioStream which decodes its parent stream ahead of time, from the
+ * timer thread, into a ring buffer. Reading from it only copies the decoded
+ * samples and never waits for the decoder. If the buffer runs empty, a read
+ * is padded with silence until the decoder caught up.
+ *
+ * The buffer is filled when the stream is created, so playback starts
+ * without a gap.
+ */
+class DecodeAheadAudioStream : public virtual AudioStream {
+public:
+	DecodeAheadAudioStream(AudioStream *parentStream, SeekableAudioStream *seekableParent, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse);
+	~DecodeAheadAudioStream();
+
+	int readBuffer(int16 *buffer, const int numSamples) { return _buffer->read(buffer, numSamples); }
+	bool endOfData() const { return _buffer->endOfData(); }
+	bool endOfStream() const { return _buffer->endOfStream(); }
+	bool isStereo() const { return _isStereo; }
+	int getRate() const { return _rate; }
+
+protected:
+	DecodeAheadBuffer *_buffer;
+
+private:
+	const bool _isStereo;
+	const int _rate;
+};
+
+DecodeAheadAudioStream::DecodeAheadAudioStream(AudioStream *parentStream, SeekableAudioStream *seekableParent, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse)
+	: _buffer(new DecodeAheadBuffer(parentStream, seekableParent, lookahead, disposeAfterUse)), _isStereo(parentStream->isStereo()), _rate(parentStream->getRate()) {
+	assert(g_decodeAheadMutex);
+	_buffer->fill();
+
+	bool installTimer;
+	{
+		Common::StackLock lock(*g_decodeAheadMutex);
+		g_decodeAheadBuffers->push_back(_buffer);
+		installTimer = !g_decodeAheadTimerInstalled;
+		g_decodeAheadTimerInstalled = true;
+	}
+
+	// Installing the timer callback while holding the list lock could dead
+	// lock with the timer thread. It stays installed until the mixer goes.
+	if (installTimer)
+		g_system->getTimerManager()->installTimerProc(&decodeAheadTimerProc, kDecodeAheadInterval * 1000, 0, "DecodeAheadAudioStream");
+}
+
+DecodeAheadAudioStream::~DecodeAheadAudioStream() {
+	// This may run on the mixer thread, so it must not wait for the
+	// decoder. If the buffer is being decoded right now, the timer callback
+	// deletes it when it is done.
+	bool busy;
+	{
+		Common::StackLock lock(*g_decodeAheadMutex);
+		for (uint i = 0; i < g_decodeAheadBuffers->size(); ++i) {
+			if ((*g_decodeAheadBuffers)[i] == _buffer) {
+				g_decodeAheadBuffers->remove_at(i);
+				break;
+			}
+		}
+		busy = _buffer->_busy;
+		_buffer->_released = true;
+	}
+
+	if (!busy)
+		delete _buffer;
+}
+
+/**
+ * Seekable variant of DecodeAheadAudioStream. Looping streams seek from the
+ * mixer thread, so seeking only drops the samples decoded so far and leaves
+ * the actual seek to the decoder. Until that decoded the first chunk from
+ * the new position, reads return silence.
+ */
+class SeekableDecodeAheadAudioStream : public DecodeAheadAudioStream, public SeekableAudioStream {
+public:
+	SeekableDecodeAheadAudioStream(SeekableAudioStream *parentStream, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse)
+		: DecodeAheadAudioStream(parentStream, parentStream, lookahead, disposeAfterUse), _length(parentStream->getLength()) {}
+
+	bool seek(const Timestamp &where) {
+		if (where > _length)
+			return false;
+
+		_buffer->requestSeek(where);
+		return true;
+	}
+
+	Timestamp getLength() const { return _length; }
+
+private:
+	const Timestamp _length;
+};
+
+AudioStream *makeDecodeAheadAudioStream(AudioStream *parentStream, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse) {
+	return new DecodeAheadAudioStream(parentStream, nullptr, lookahead, disposeAfterUse);
+}
+
+SeekableAudioStream *makeDecodeAheadAudioStream(SeekableAudioStream *parentStream, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse) {
+	return new SeekableDecodeAheadAudioStream(parentStream, lookahead, disposeAfterUse);
+}
+
 /**
  * An AudioStream that plays nothing and immediately returns that
  * the endOfStream() has been reached
@@ -371,6 +371,44 @@ Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo
  */
 AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp &length, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
+/**
+ * Factory function for an AudioStream wrapper which decodes its parent
+ * stream ahead of time on the timer thread, so that reading from it while
+ * mixing only copies samples. This is useful for compressed streams, whose
+ * decoding would otherwise happen on the audio thread.
+ *
+ * The timer callback decodes 20 ms of audio per stream every 10 ms, and
+ * leaves streams to the next call once it spent 4 ms, so that other timers
+ * are not delayed much. Should the buffer still run empty, the missing
+ * samples are silence instead of ending the stream.
+ *
+ * initDecodeAheadStreams() must have been called before.
+ *
+ * @param parentStream    The stream to decode ahead
+ * @param lookahead       The amount of audio to decode ahead, in milliseconds
+ * @param disposeAfterUse Whether the parent stream object should be destroyed on destruction of the returned stream
+ */
+AudioStream *makeDecodeAheadAudioStream(AudioStream *parentStream, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+/**
+ * Seekable variant of the above. Seeking discards the samples decoded so
+ * far. The parent is seeked by the decoder, and the stream plays silence
+ * until the first samples from the new position are decoded.
+ */
+SeekableAudioStream *makeDecodeAheadAudioStream(SeekableAudioStream *parentStream, uint32 lookahead, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+/**
+ * Set up the state shared by all decode ahead streams. The mixer calls this
+ * when it is created, before any other thread could create such a stream.
+ */
+void initDecodeAheadStreams();
+
+/**
+ * Stop decoding ahead and free the shared state, once no decode ahead
+ * streams are left. The mixer calls this when it is destroyed.
+ */
+void deinitDecodeAheadStreams();
+
 /**
  * An AudioStream designed to work in terms of packets.
  *
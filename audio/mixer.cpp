@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -43,7 +44,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, bool highQuality, int id, bool permanent);
 	~Channel();
 
 	/**
@@ -80,7 +81,7 @@ public:
 	 * @param paused true, when the channel should be paused.
 	 *               false when it should be unpaused.
 	 */
-	void pause(bool paused);
+	void pause(bool paused, uint32 time);
 
 	/**
 	 * Queries whether the channel is currently paused.
@@ -173,23 +174,32 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _highQualityResampling(ConfMan.get("audio_resampler") == "sinc"), _commandsStart(0), _commandsCount(0) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
+
+	initDecodeAheadStreams();
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	deinitDecodeAheadStreams();
 }
 
 void MixerImpl::setReady(bool ready) {
 	_mixerReady = ready;
 }
 
+void MixerImpl::setHighQualityResampling(bool enable) {
+	_highQualityResampling = enable;
+}
+
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
@@ -219,6 +229,102 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		*handle = chanHandle;
 }
 
+Channel *MixerImpl::findChannel(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+		return 0;
+
+	return _channels[index];
+}
+
+void MixerImpl::postCommand(CommandType type, int target, int value) {
+	Command command;
+	command.type = type;
+	command.target = target;
+	command.value = value;
+	command.time = g_system->getMillis(true);
+
+	_commandMutex.lock();
+	while (_commandsCount == COMMAND_QUEUE_SIZE) {
+		// The mixer is not keeping up, so apply the queued commands right
+		// away. The mixer mutex has to be taken first, and another thread
+		// may fill up the queue again in the meantime.
+		_commandMutex.unlock();
+		Common::StackLock lock(_mutex);
+		applyCommands();
+		_commandMutex.lock();
+	}
+
+	_commands[(_commandsStart + _commandsCount) % COMMAND_QUEUE_SIZE] = command;
+	_commandsCount++;
+	_commandMutex.unlock();
+}
+
+void MixerImpl::applyCommands() {
+	Common::StackLock lock(_commandMutex);
+
+	for (; _commandsCount > 0; _commandsCount--, _commandsStart = (_commandsStart + 1) % COMMAND_QUEUE_SIZE) {
+		const Command &command = _commands[_commandsStart];
+		SoundHandle handle;
+		handle._val = command.target;
+
+		switch (command.type) {
+		case kCommandSetVolume:
+			if (Channel *chan = findChannel(handle))
+				chan->setVolume(command.value);
+			break;
+
+		case kCommandSetBalance:
+			if (Channel *chan = findChannel(handle))
+				chan->setBalance(command.value);
+			break;
+
+		case kCommandPauseAll:
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_channels[i] != 0)
+					_channels[i]->pause(command.value != 0, command.time);
+			}
+			break;
+
+		case kCommandPauseID:
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_channels[i] != 0 && _channels[i]->getId() == command.target) {
+					_channels[i]->pause(command.value != 0, command.time);
+					break;
+				}
+			}
+			break;
+
+		case kCommandPauseHandle:
+			// Simply ignore (un)pause requests for sounds that already terminated
+			if (Channel *chan = findChannel(handle))
+				chan->pause(command.value != 0, command.time);
+			break;
+
+		case kCommandUpdateVolumes:
+			for (int i = 0; i != NUM_CHANNELS; ++i) {
+				if (_channels[i] && _channels[i]->getType() == command.target)
+					_channels[i]->notifyGlobalVolChange();
+			}
+			break;
+		}
+	}
+}
+
+bool MixerImpl::findPendingCommand(CommandType type, SoundHandle handle, int &value) {
+	Common::StackLock lock(_commandMutex);
+
+	bool found = false;
+	for (uint i = 0; i < _commandsCount; i++) {
+		const Command &command = _commands[(_commandsStart + i) % COMMAND_QUEUE_SIZE];
+		if (command.type == type && command.target == (int)handle._val) {
+			value = command.value;
+			found = true;
+		}
+	}
+	return found;
+}
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -227,8 +333,6 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
-
 	if (stream == 0) {
 		warning("stream is 0");
 		return;
@@ -237,6 +341,19 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+#ifdef AUDIO_REVERSE_STEREO
+	reverseStereo = !reverseStereo;
+#endif
+
+	// Create the channel before taking the lock, setting up the rate
+	// converter may take a while
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, _highQualityResampling, id, permanent);
+	chan->setVolume(volume);
+	chan->setBalance(balance);
+
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
@@ -247,20 +364,11 @@ void MixerImpl::playStream(
 				// keep in mind here is QueuingAudioStream.
 				// Thus, as a quick rule of thumb, you should never, ever,
 				// try to play QueuingAudioStreams with a sound id.
-				if (autofreeStream == DisposeAfterUse::YES)
-					delete stream;
+				delete chan;
 				return;
 			}
 	}
 
-#ifdef AUDIO_REVERSE_STEREO
-	reverseStereo = !reverseStereo;
-#endif
-
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
-	chan->setVolume(volume);
-	chan->setBalance(balance);
 	insertChannel(handle, chan);
 }
 
@@ -277,6 +385,8 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	applyCommands();
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
@@ -300,6 +410,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
 			delete _channels[i];
@@ -310,6 +421,7 @@ void MixerImpl::stopAll() {
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			delete _channels[i];
@@ -320,6 +432,7 @@ void MixerImpl::stopID(int id) {
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
@@ -332,30 +445,32 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+	{
+		// The mixer reads the settings while applying the command
+		Common::StackLock lock(_commandMutex);
+		_soundTypeSettings[type].mute = mute;
 	}
+
+	postCommand(kCommandUpdateVolumes, type, 0);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+	Common::StackLock lock(_commandMutex);
 	return _soundTypeSettings[type].mute;
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	postCommand(kCommandSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	// Report the volume that will be used, even if it has not been
+	// applied yet
+	int volume;
+	if (findPendingCommand(kCommandSetVolume, handle, volume))
+		return volume;
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -364,16 +479,14 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	postCommand(kCommandSetBalance, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	int balance;
+	if (findPendingCommand(kCommandSetBalance, handle, balance))
+		return balance;
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -387,6 +500,7 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	applyCommands();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -396,33 +510,15 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
-	}
+	postCommand(kCommandPauseAll, 0, paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
-		}
-	}
+	postCommand(kCommandPauseID, id, paused);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	postCommand(kCommandPauseHandle, handle._val, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -474,18 +570,19 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+	{
+		// The mixer reads the settings while applying the command
+		Common::StackLock lock(_commandMutex);
+		_soundTypeSettings[type].volume = volume;
 	}
+
+	postCommand(kCommandUpdateVolumes, type, 0);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 
+	Common::StackLock lock(_commandMutex);
 	return _soundTypeSettings[type].volume;
 }
 
@@ -495,7 +592,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, bool highQuality, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
@@ -504,7 +601,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, highQuality);
 }
 
 Channel::~Channel() {
@@ -556,19 +653,19 @@ void Channel::updateChannelVolumes() {
 	}
 }
 
-void Channel::pause(bool paused) {
+void Channel::pause(bool paused, uint32 time) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
 	if (paused) {
 		_pauseLevel++;
 
 		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
+			_pauseStartTime = time;
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
+			_pauseTime = (time - _pauseStartTime);
 			_pauseStartTime = 0;
 		}
 	}
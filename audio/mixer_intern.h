@@ -46,16 +46,52 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * Changes to the volume, balance and pause state of channels do not wait
+ * for the mixer callback to finish. They are put into a command queue,
+ * which is protected by its own mutex and only ever held briefly, and the
+ * mixer callback applies them before mixing the next buffer. Operations
+ * which start or stop sounds remain synchronous, since callers may free
+ * the sound data right after stopping it.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 64
+	};
+
+	enum CommandType {
+		kCommandSetVolume,
+		kCommandSetBalance,
+		kCommandPauseAll,
+		kCommandPauseID,
+		kCommandPauseHandle,
+		kCommandUpdateVolumes
+	};
+
+	/** A channel state change, waiting to be applied by the mixer */
+	struct Command {
+		CommandType type;
+		/** Handle, sound ID or sound type the command applies to */
+		int target;
+		int value;
+		/** Time the command was issued at, for pausing */
+		uint32 time;
 	};
 
 	Common::Mutex _mutex;
 
+	/**
+	 * Protects the command queue and the sound type settings, never held
+	 * across mixing
+	 */
+	mutable Common::Mutex _commandMutex;
+	Command _commands[COMMAND_QUEUE_SIZE];
+	uint _commandsStart;
+	uint _commandsCount;
+
 	const uint _sampleRate;
 	bool _mixerReady;
 	uint32 _handleSeed;
@@ -70,6 +106,8 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	bool _highQualityResampling;
+
 
 public:
 
@@ -121,6 +159,17 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/** Queue a channel state change */
+	void postCommand(CommandType type, int target, int value);
+
+	/** Apply all queued commands. Must be called with _mutex held. */
+	void applyCommands();
+
+	/** Find the latest queued value of a command for a handle */
+	bool findPendingCommand(CommandType type, SoundHandle handle, int &value);
+
+	Channel *findChannel(SoundHandle handle) const;
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -139,6 +188,14 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Select the rate converter used for sounds started from now on.
+	 * The high quality converter uses band-limited interpolation, which
+	 * costs more CPU time than the default linear interpolation. The
+	 * initial setting is taken from the "audio_resampler" config option.
+	 */
+	void setHighQualityResampling(bool enable);
 };
 
 
@@ -35,6 +35,14 @@
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#if defined(__SSE2__) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define RATE_USE_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define RATE_USE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Audio {
 
 
@@ -57,6 +65,76 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * The number of sample pairs the converters resample in one go before
+ * mixing them into the output buffer.
+ */
+#define MIX_BUFFER_FRAMES 256
+
+/**
+ * Mix a block of interleaved stereo samples into the output buffer, which
+ * is the same as calling
+ *   clampedAdd(obuf[i], (samples[i] * vol) / Audio::Mixer::kMaxMixerVolume)
+ * for every sample, with vol_even applied to the even (first) and vol_odd
+ * applied to the odd (second) sample of each pair.
+ *
+ * Where available, this uses SSE2 or NEON. Both produce exactly the same
+ * result as the scalar code: the products are divided with rounding towards
+ * zero, and the saturating addition matches clampedAdd().
+ */
+static void mixSamples(st_sample_t *obuf, const st_sample_t *samples, st_size_t frames, st_volume_t vol_even, st_volume_t vol_odd) {
+	st_size_t count = frames * 2;
+
+#if defined(RATE_USE_SSE2) || defined(RATE_USE_NEON)
+	STATIC_ASSERT(Audio::Mixer::kMaxMixerVolume == 256, mixer_volume_must_be_a_shift_by_eight);
+
+	// Larger volumes could make the scaled sample itself overflow
+	if (vol_even <= Audio::Mixer::kMaxMixerVolume && vol_odd <= Audio::Mixer::kMaxMixerVolume) {
+#if defined(RATE_USE_SSE2)
+		const __m128i vol = _mm_set_epi16(vol_odd, vol_even, vol_odd, vol_even, vol_odd, vol_even, vol_odd, vol_even);
+		const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+		for (; count >= 8; count -= 8, samples += 8, obuf += 8) {
+			const __m128i in = _mm_loadu_si128((const __m128i *)samples);
+			const __m128i lo = _mm_mullo_epi16(in, vol);
+			const __m128i hi = _mm_mulhi_epi16(in, vol);
+			__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+			__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+			// Round negative values towards zero, like the division does
+			p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+			p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+
+			const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+			_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, _mm_packs_epi32(p0, p1)));
+		}
+#else
+		const int16 volArray[4] = { (int16)vol_even, (int16)vol_odd, (int16)vol_even, (int16)vol_odd };
+		const int16x4_t vol = vld1_s16(volArray);
+		const int32x4_t bias = vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1);
+
+		for (; count >= 8; count -= 8, samples += 8, obuf += 8) {
+			const int16x8_t in = vld1q_s16(samples);
+			int32x4_t p0 = vmull_s16(vget_low_s16(in), vol);
+			int32x4_t p1 = vmull_s16(vget_high_s16(in), vol);
+
+			// Round negative values towards zero, like the division does
+			p0 = vshrq_n_s32(vaddq_s32(p0, vandq_s32(vshrq_n_s32(p0, 31), bias)), 8);
+			p1 = vshrq_n_s32(vaddq_s32(p1, vandq_s32(vshrq_n_s32(p1, 31), bias)), 8);
+
+			const int16x8_t out = vld1q_s16(obuf);
+			vst1q_s16(obuf, vqaddq_s16(out, vcombine_s16(vmovn_s32(p0), vmovn_s32(p1))));
+		}
+#endif
+	}
+#endif
+
+	for (; count > 0; count -= 2, samples += 2, obuf += 2) {
+		clampedAdd(obuf[0], (samples[0] * (int)vol_even) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (samples[1] * (int)vol_odd) / Audio::Mixer::kMaxMixerVolume);
+	}
+}
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -114,42 +192,53 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 template<bool stereo, bool reverseStereo>
 int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
+	st_sample_t mixBuf[MIX_BUFFER_FRAMES * 2];
+	bool eof = false;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
+	while (obuf < oend && !eof) {
+		st_sample_t *mixPtr = mixBuf;
+		st_sample_t *mixEnd = mixBuf + MIN<int>(oend - obuf, ARRAYSIZE(mixBuf));
+
+		while (mixPtr < mixEnd) {
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						eof = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (eof)
+				break;
 
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
-
-		// Increment output position
-		opos += opos_inc;
+			st_sample_t out0, out1;
+			out0 = *inPtr++;
+			out1 = (stereo ? *inPtr++ : out0);
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			mixPtr[reverseStereo    ] = out0;
+			mixPtr[reverseStereo ^ 1] = out1;
+			mixPtr += 2;
+		}
 
-		obuf += 2;
+		// output left and right channel
+		mixSamples(obuf, mixBuf, (mixPtr - mixBuf) / 2, reverseStereo ? vol_r : vol_l, reverseStereo ? vol_l : vol_r);
+		obuf += mixPtr - mixBuf;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -227,48 +316,60 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+	st_sample_t mixBuf[MIX_BUFFER_FRAMES * 2];
+	bool eof = false;
+
+	while (obuf < oend && !eof) {
+		st_sample_t *mixPtr = mixBuf;
+		st_sample_t *mixEnd = mixBuf + MIN<int>(oend - obuf, ARRAYSIZE(mixBuf));
+
+		while (mixPtr < mixEnd) {
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						eof = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (eof)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the mix buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && mixPtr < mixEnd) {
+				// interpolate
+				st_sample_t out0, out1;
+				out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				out1 = (stereo ?
+							  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
+							  out0);
+
+				mixPtr[reverseStereo    ] = out0;
+				mixPtr[reverseStereo ^ 1] = out1;
+				mixPtr += 2;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-
-			// Increment output position
-			opos += opos_inc;
-		}
+		// output left and right channel
+		mixSamples(obuf, mixBuf, (mixPtr - mixBuf) / 2, reverseStereo ? vol_r : vol_l, reverseStereo ? vol_l : vol_r);
+		obuf += mixPtr - mixBuf;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -315,19 +416,29 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
+		if (stereo && !reverseStereo) {
+			mixSamples(obuf, _buffer, len / 2, vol_l, vol_r);
+			obuf += len;
+		} else {
+			st_sample_t mixBuf[MIX_BUFFER_FRAMES * 2];
+
+			ptr = _buffer;
+			while (len >= (stereo ? 2u : 1u)) {
+				const st_size_t frames = MIN<st_size_t>(len / (stereo ? 2 : 1), MIX_BUFFER_FRAMES);
+				for (st_size_t i = 0; i < frames; ++i) {
+					st_sample_t out0, out1;
+					out0 = *ptr++;
+					out1 = (stereo ? *ptr++ : out0);
+
+					mixBuf[2 * i + reverseStereo    ] = out0;
+					mixBuf[2 * i + (reverseStereo ^ 1)] = out1;
+				}
+
+				// output left and right channel
+				mixSamples(obuf, mixBuf, frames, reverseStereo ? vol_r : vol_l, reverseStereo ? vol_l : vol_r);
+				obuf += frames * 2;
+				len -= frames * (stereo ? 2 : 1);
+			}
 		}
 		return (obuf - ostart) / 2;
 	}
@@ -338,11 +449,249 @@ public:
 };
 
 
+#pragma mark -
+
+
+/**
+ * Dot product of a block of samples with a filter. The length must be a
+ * multiple of 8.
+ */
+static int dotProduct(const st_sample_t *samples, const int16 *filter, uint length) {
+#if defined(RATE_USE_SSE2)
+	__m128i sum = _mm_setzero_si128();
+	for (uint i = 0; i < length; i += 8) {
+		const __m128i x = _mm_loadu_si128((const __m128i *)(samples + i));
+		const __m128i h = _mm_loadu_si128((const __m128i *)(filter + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(x, h));
+	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+#elif defined(RATE_USE_NEON)
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint i = 0; i < length; i += 8) {
+		const int16x8_t x = vld1q_s16(samples + i);
+		const int16x8_t h = vld1q_s16(filter + i);
+		sum = vmlal_s16(sum, vget_low_s16(x), vget_low_s16(h));
+		sum = vmlal_s16(sum, vget_high_s16(x), vget_high_s16(h));
+	}
+	return vgetq_lane_s32(sum, 0) + vgetq_lane_s32(sum, 1) + vgetq_lane_s32(sum, 2) + vgetq_lane_s32(sum, 3);
+#else
+	int sum = 0;
+	for (uint i = 0; i < length; ++i)
+		sum += samples[i] * filter[i];
+	return sum;
+#endif
+}
+
+/**
+ * Zeroth order modified Bessel function of the first kind, used for the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+/**
+ * High quality audio rate converter using band-limited interpolation.
+ *
+ * Each output sample is the dot product of the input around its position
+ * with a Kaiser windowed sinc filter. The filter is precomputed for
+ * SINC_PHASES fractional positions, the nearest of which is used. One more
+ * filter covers the position of the next input sample, which positions past
+ * the last phase round to. When downsampling, the cutoff frequency is lowered
+ * to the output Nyquist frequency and the filter gets longer accordingly.
+ *
+ * The filter bank is computed using floating point arithmetic when the
+ * converter is created; the conversion itself uses integers only.
+ */
+enum {
+	SINC_PHASES = 256,
+	SINC_ZERO_CROSSINGS = 8,
+	SINC_MAX_TAPS = 128,
+	SINC_HISTORY_SIZE = 1024,
+	SINC_COEF_BITS = 14
+};
+
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** Input samples of each channel, starting with the oldest one still needed */
+	st_sample_t _history[stereo ? 2 : 1][SINC_HISTORY_SIZE + SINC_MAX_TAPS];
+	/** Number of valid samples in the history */
+	uint _historyLen;
+	/** Index of the first sample the filter is applied to */
+	uint _start;
+
+	/** Fractional position between two input samples, in units of 1/outrate */
+	st_rate_t _frac;
+
+	st_rate_t _inrate, _outrate;
+
+	uint _taps;
+	/** SINC_PHASES + 1 filters with _taps coefficients each */
+	int16 *_filters;
+
+	bool refill(AudioStream &input);
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+	~SincRateConverter() {
+		delete[] _filters;
+	}
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate)
+	: _historyLen(0), _start(0), _frac(0), _inrate(inrate), _outrate(outrate) {
+	const double cutoff = MIN(1.0, (double)outrate / inrate);
+
+	// The filter spans the same number of zero crossings, whatever the cutoff
+	_taps = MIN<uint>(((uint)(2 * SINC_ZERO_CROSSINGS / cutoff) + 7) & ~7, SINC_MAX_TAPS);
+	_filters = new int16[(SINC_PHASES + 1) * _taps];
+
+	const int half = _taps / 2;
+	const double beta = 7.0;
+	const double windowScale = 1.0 / besselI0(beta);
+
+	for (uint phase = 0; phase <= SINC_PHASES; ++phase) {
+		int16 *filter = _filters + phase * _taps;
+		double coefs[SINC_MAX_TAPS];
+		double total = 0;
+
+		for (uint k = 0; k < _taps; ++k) {
+			// Distance of the input sample from the output position
+			const double x = (int)k - half + 1 - (double)phase / SINC_PHASES;
+			const double t = x / half;
+			const double window = (t <= -1.0 || t >= 1.0) ? 0.0 : besselI0(beta * sqrt(1.0 - t * t)) * windowScale;
+			const double arg = M_PI * cutoff * x;
+			const double sinc = (x == 0.0) ? 1.0 : sin(arg) / arg;
+
+			coefs[k] = cutoff * sinc * window;
+			total += coefs[k];
+		}
+
+		// Normalize to unity gain, and put the rounding error into the
+		// largest coefficient
+		int sum = 0;
+		uint largest = 0;
+		for (uint k = 0; k < _taps; ++k) {
+			filter[k] = (int16)floor(coefs[k] / total * (1 << SINC_COEF_BITS) + 0.5);
+			sum += filter[k];
+			if (filter[k] > filter[largest])
+				largest = k;
+		}
+		filter[largest] += (1 << SINC_COEF_BITS) - sum;
+	}
+
+	// Center the filter on the first input sample
+	for (uint c = 0; c < (stereo ? 2 : 1); ++c)
+		memset(_history[c], 0, sizeof(st_sample_t) * (half - 1));
+	_historyLen = half - 1;
+}
+
+/*
+ * Read more input into the history, dropping the samples which are not
+ * needed anymore. Returns false at the end of the input.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	// When downsampling, the filter may have skipped past the history
+	const uint drop = MIN(_start, _historyLen);
+	if (drop) {
+		for (uint c = 0; c < (stereo ? 2 : 1); ++c)
+			memmove(_history[c], _history[c] + drop, sizeof(st_sample_t) * (_historyLen - drop));
+		_historyLen -= drop;
+		_start -= drop;
+	}
+
+	const uint space = MIN<uint>(SINC_HISTORY_SIZE + SINC_MAX_TAPS - _historyLen, ARRAYSIZE(inBuf) / 2);
+	const int len = input.readBuffer(inBuf, space * (stereo ? 2 : 1));
+	if (len <= 0)
+		return false;
+
+	const st_sample_t *inPtr = inBuf;
+	for (int i = 0; i < len; i += (stereo ? 2 : 1)) {
+		_history[0][_historyLen] = *inPtr++;
+		if (stereo)
+			_history[stereo ? 1 : 0][_historyLen] = *inPtr++;
+		_historyLen++;
+	}
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+	st_sample_t mixBuf[MIX_BUFFER_FRAMES * 2];
+	bool eof = false;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend && !eof) {
+		st_sample_t *mixPtr = mixBuf;
+		st_sample_t *mixEnd = mixBuf + MIN<int>(oend - obuf, ARRAYSIZE(mixBuf));
+
+		while (mixPtr < mixEnd) {
+			// read enough input samples to cover the whole filter
+			if (_start + _taps > _historyLen) {
+				if (!refill(input)) {
+					eof = true;
+					break;
+				}
+				continue;
+			}
+
+			const uint phase = (uint)(((uint64)_frac * SINC_PHASES + _outrate / 2) / _outrate);
+			const int16 *filter = _filters + phase * _taps;
+			const int round = 1 << (SINC_COEF_BITS - 1);
+
+			st_sample_t out0, out1;
+			out0 = (st_sample_t)CLIP<int>((dotProduct(_history[0] + _start, filter, _taps) + round) >> SINC_COEF_BITS,
+			                              ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+			out1 = (stereo ?
+			        (st_sample_t)CLIP<int>((dotProduct(_history[stereo ? 1 : 0] + _start, filter, _taps) + round) >> SINC_COEF_BITS,
+			                               ST_SAMPLE_MIN, ST_SAMPLE_MAX) :
+			        out0);
+
+			mixPtr[reverseStereo    ] = out0;
+			mixPtr[reverseStereo ^ 1] = out1;
+			mixPtr += 2;
+
+			// Increment output position
+			_frac += _inrate;
+			_start += _frac / _outrate;
+			_frac %= _outrate;
+		}
+
+		// output left and right channel
+		mixSamples(obuf, mixBuf, (mixPtr - mixBuf) / 2, reverseStereo ? vol_r : vol_l, reverseStereo ? vol_l : vol_r);
+		obuf += mixPtr - mixBuf;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
-	if (inrate != outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool highQuality) {
+	if (inrate != outrate && highQuality) {
+		return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+	} else if (inrate != outrate) {
 		if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
@@ -356,14 +705,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, bool highQuality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, highQuality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, highQuality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, highQuality);
 }
 
 } // End of namespace Audio
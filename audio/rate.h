@@ -78,7 +78,16 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * Create a RateConverter for the given input and output rates.
+ *
+ * @param highQuality use band-limited interpolation instead of linear
+ *                    interpolation when the rates differ. This is several
+ *                    times as expensive, but avoids audible aliasing when
+ *                    upsampling low quality samples. It is not supported
+ *                    by the ARM assembly converters.
+ */
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, bool highQuality = false);
 
 } // End of namespace Audio
 
@@ -147,6 +147,15 @@ public:
 	 */
 	virtual bool isDirectory() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified,
+	 * in seconds since an arbitrary (but fixed) epoch.
+	 *
+	 * @note By default, this method returns 0, meaning that the modification
+	 *       time is unknown.
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
 	/**
 	 * Indicates whether the object referred by this path can be read from or not.
 	 *
@@ -64,6 +64,17 @@ public:
 	 * On Windows, it will be a special node which "contains" all drives (C:, D:, E:).
 	 */
 	virtual AbstractFSNode *makeRootFileNode() const = 0;
+
+	/**
+	 * Returns the current time, in the clock which the modification times
+	 * of the nodes are given in.
+	 *
+	 * @note By default, this method returns 0, meaning that the time is
+	 *       unknown.
+	 *
+	 * @see AbstractFSNode::getModificationTime
+	 */
+	virtual uint32 getCurrentTime() const { return 0; }
 };
 
 #endif /*FILESYSTEM_FACTORY_H*/
@@ -34,6 +34,7 @@
 #include "backends/fs/posix/posix-fs-factory.h"
 #include "backends/fs/posix/posix-fs.h"
 
+#include <time.h>
 #include <unistd.h>
 
 AbstractFSNode *POSIXFilesystemFactory::makeRootFileNode() const {
@@ -63,4 +64,8 @@ AbstractFSNode *POSIXFilesystemFactory::makeFileNodePath(const Common::String &p
 	assert(!path.empty());
 	return new POSIXFilesystemNode(path);
 }
+
+uint32 POSIXFilesystemFactory::getCurrentTime() const {
+	return (uint32)time(nullptr);
+}
 #endif
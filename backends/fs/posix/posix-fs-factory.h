@@ -35,6 +35,7 @@ protected:
 	virtual AbstractFSNode *makeRootFileNode() const;
 	virtual AbstractFSNode *makeCurrentDirectoryFileNode() const;
 	virtual AbstractFSNode *makeFileNodePath(const Common::String &path) const;
+	virtual uint32 getCurrentTime() const;
 };
 
 #endif /*POSIX_FILESYSTEM_FACTORY_H*/
@@ -59,6 +59,7 @@ public:
 	virtual Common::String getName() const { return _displayName; }
 	virtual Common::String getPath() const { return _path; }
 	virtual bool isDirectory() const { return _isDirectory; }
+	virtual uint32 getModificationTime() const;
 	virtual bool isReadable() const;
 	virtual bool isWritable() const;
 
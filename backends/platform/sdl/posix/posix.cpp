@@ -271,6 +271,32 @@ void OSystem_POSIX::addSysArchivesToSearchSet(Common::SearchSet &s, int priority
 	OSystem_SDL::addSysArchivesToSearchSet(s, priority);
 }
 
+Common::String OSystem_POSIX::getCachePath() {
+	Common::String path = OSystem_SDL::getCachePath();
+	if (!path.empty())
+		return path;
+
+	// Follow the XDG Base Directory Specification, just like for the log
+	// file below
+	const char *prefix = getenv("XDG_CACHE_HOME");
+	if (prefix == nullptr || !*prefix) {
+		prefix = getenv("HOME");
+		if (prefix == nullptr) {
+			return Common::String();
+		}
+
+		path = ".cache/";
+	}
+
+	path += "scummvm";
+
+	if (!Posix::assureDirectoryExists(path, prefix)) {
+		return Common::String();
+	}
+
+	return Common::String::format("%s/%s", prefix, path.c_str());
+}
+
 Common::String OSystem_POSIX::getDefaultLogFileName() {
 	Common::String logFile;
 
@@ -40,6 +40,8 @@ public:
 
 	Common::String getScreenshotsPath() override;
 
+	virtual Common::String getCachePath() override;
+
 protected:
 	virtual Common::String getDefaultConfigFileName() override;
 	virtual Common::String getDefaultLogFileName() override;
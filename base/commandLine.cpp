@@ -82,6 +82,8 @@ static const char HELP_STRING[] =
 	"  --auto-detect            Display a list of games from current or specified directory\n"
 	"                           and start the first one. Use --path=PATH to specify a directory.\n"
 	"  --recursive              In combination with --add or --detect recurse down all subdirectories\n"
+	"  --benchmark              In combination with --add or --detect report how long the\n"
+	"                           detection took\n"
 #if defined(WIN32) && !defined(__SYMBIAN32__)
 	"  --console                Enable the console window (default:enabled)\n"
 #endif
@@ -222,6 +224,8 @@ void registerDefaults() {
 	ConfMan.registerDefault("stretch_mode", "default");
 
 	// Sound & Music
+	ConfMan.registerDefault("audio_resampler", "default");
+	ConfMan.registerDefault("audio_decode_ahead", 0);
 	ConfMan.registerDefault("music_volume", 192);
 	ConfMan.registerDefault("sfx_volume", 192);
 	ConfMan.registerDefault("speech_volume", 192);
@@ -247,6 +251,8 @@ void registerDefaults() {
 
 	// Game specific
 	ConfMan.registerDefault("path", "");
+	ConfMan.registerDefault("fs_cache", false);
+	ConfMan.registerDefault("detection_cache", false);
 	ConfMan.registerDefault("platform", Common::kPlatformDOS);
 	ConfMan.registerDefault("language", "en");
 	ConfMan.registerDefault("subtitles", false);
@@ -699,6 +705,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("recursive")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("benchmark")
+			END_OPTION
+
 			DO_LONG_OPTION("themepath")
 				Common::FSNode path(option);
 				if (!path.exists()) {
@@ -947,6 +956,35 @@ static void listAudioDevices() {
 	}
 }
 
+/** Statistics about the directories scanned by --detect and --add */
+struct DetectionScanStats {
+	uint32 startTime;
+	uint dirs;
+	uint files;
+};
+
+static DetectionScanStats s_scanStats;
+
+static void beginDetectionScan() {
+	s_scanStats.startTime = g_system->getMillis();
+	s_scanStats.dirs = 0;
+	s_scanStats.files = 0;
+
+	FilePropsCache.beginScan();
+}
+
+static void endDetectionScan(bool benchmark) {
+	FilePropsCache.endScan();
+
+	if (!benchmark)
+		return;
+
+	const uint32 time = MAX<uint32>(g_system->getMillis() - s_scanStats.startTime, 1);
+	printf("Scanned %u directories and %u files in %u ms (%u files/sec)\n",
+	       s_scanStats.dirs, s_scanStats.files, time, (uint)((uint64)s_scanStats.files * 1000 / time));
+	printf("File properties cache: %u hits, %u misses\n", FilePropsCache.getHits(), FilePropsCache.getMisses());
+}
+
 /** Display all games in the given directory, or current directory if empty */
 static DetectedGames getGameList(const Common::FSNode &dir) {
 	Common::FSList files;
@@ -957,6 +995,9 @@ static DetectedGames getGameList(const Common::FSNode &dir) {
 		return DetectedGames();
 	}
 
+	s_scanStats.dirs++;
+	s_scanStats.files += files.size();
+
 	// detect Games
 	DetectionResults detectionResults = EngineMan.detectGames(files);
 
@@ -1331,10 +1372,14 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 			}
 		}
 	} else if (command == "detect") {
+		beginDetectionScan();
 		detectGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
+		endDetectionScan(settings["benchmark"] == "true");
 		return true;
 	} else if (command == "add") {
+		beginDetectionScan();
 		addGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
+		endDetectionScan(settings["benchmark"] == "true");
 		return true;
 	}
 #ifdef DETECTOR_TESTING_HACK
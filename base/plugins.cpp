@@ -536,6 +536,7 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const
 	DetectedGames candidates;
 	PluginList plugins;
 	PluginList::const_iterator iter;
+	FilePropsCache.beginScan();
 	PluginMan.loadFirstPlugin();
 	do {
 		plugins = getPlugins();
@@ -553,6 +554,7 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const
 
 		}
 	} while (PluginMan.loadNextPlugin());
+	FilePropsCache.endScan();
 
 	return DetectionResults(candidates);
 }
@@ -62,6 +62,81 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 
 
 
+SearchSet::~SearchSet() {
+	clear();
+
+	// Do not leave dangling pointers to this set behind in the sets
+	// which still contain it
+	while (!_parents.empty())
+		_parents.back()->removeSet(this);
+}
+
+void SearchSet::invalidateLookupCache() {
+	++_modificationStamp;
+
+	// The SearchSets containing this one have outdated results just as well
+	for (uint i = 0; i < _parents.size(); ++i)
+		_parents[i]->invalidateLookupCache();
+}
+
+void SearchSet::unlinkNode(const Node &node) {
+	if (!node._set)
+		return;
+
+	Array<SearchSet *> &parents = node._set->_parents;
+	for (uint i = 0; i < parents.size(); ++i) {
+		if (parents[i] == this) {
+			parents.remove_at(i);
+			break;
+		}
+	}
+}
+
+void SearchSet::removeSet(SearchSet *set) {
+	ArchiveNodeList::iterator it = _list.begin();
+	while (it != _list.end()) {
+		if (it->_set == set) {
+			unlinkNode(*it);
+			it = _list.erase(it);
+		} else {
+			++it;
+		}
+	}
+	invalidateLookupCache();
+}
+
+bool SearchSet::findCachedArchive(const String &name, Archive *&archive) const {
+	if (_lookupCacheStamp != _modificationStamp) {
+		_lookupCache.clear(true);
+		_lookupCacheStamp = _modificationStamp;
+		return false;
+	}
+
+	LookupCache::const_iterator it = _lookupCache.find(name);
+	if (it == _lookupCache.end())
+		return false;
+
+	archive = it->_value;
+	return true;
+}
+
+Archive *SearchSet::findArchive(const String &name) const {
+	Archive *archive = nullptr;
+	if (findCachedArchive(name, archive))
+		return archive;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(name)) {
+			archive = it->_arc;
+			break;
+		}
+	}
+
+	_lookupCache[name] = archive;
+	return archive;
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
@@ -97,7 +172,11 @@ void SearchSet::insert(const Node &node) {
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
 	if (find(name) == _list.end()) {
 		Node node(priority, name, archive, autoFree);
+		node._set = dynamic_cast<SearchSet *>(archive);
+		if (node._set)
+			node._set->_parents.push_back(this);
 		insert(node);
+		invalidateLookupCache();
 	} else {
 		if (autoFree)
 			delete archive;
@@ -118,6 +197,15 @@ void SearchSet::addDirectory(const String &name, const FSNode &dir, int priority
 	add(name, new FSDirectory(dir, depth, flat, _ignoreClashes), priority);
 }
 
+void SearchSet::addDirectory(const String &name, const FSNode &dir, const String &cacheName, int priority, int depth, bool flat) {
+	if (!dir.exists() || !dir.isDirectory())
+		return;
+
+	FSDirectory *fsDir = new FSDirectory(dir, depth, flat, _ignoreClashes);
+	fsDir->setPersistentCache(cacheName);
+	add(name, fsDir, priority);
+}
+
 void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPattern, bool ignoreCase, int priority, int depth, bool flat) {
 	FSList subDirs;
 	if (!directory.getChildren(subDirs))
@@ -170,9 +258,11 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 void SearchSet::remove(const String &name) {
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		unlinkNode(*it);
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateLookupCache();
 	}
 }
 
@@ -182,11 +272,13 @@ bool SearchSet::hasArchive(const String &name) const {
 
 void SearchSet::clear() {
 	for (ArchiveNodeList::iterator i = _list.begin(); i != _list.end(); ++i) {
+		unlinkNode(*i);
 		if (i->_autoFree)
 			delete i->_arc;
 	}
 
 	_list.clear();
+	invalidateLookupCache();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -203,19 +295,14 @@ void SearchSet::setPriority(const String &name, int priority) {
 	_list.erase(it);
 	node._priority = priority;
 	insert(node);
+	invalidateLookupCache();
 }
 
 bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return true;
-	}
-
-	return false;
+	return findArchive(name) != nullptr;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
@@ -242,26 +329,42 @@ const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
 	if (name.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return it->_arc->getMember(name);
-	}
+	Archive *archive = findArchive(name);
+	if (!archive)
+		return ArchiveMemberPtr();
 
-	return ArchiveMemberPtr();
+	return archive->getMember(name);
 }
 
 SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) const {
 	if (name.empty())
 		return nullptr;
 
+	Archive *archive = nullptr;
+	bool cached = findCachedArchive(name, archive);
+	if (cached) {
+		if (!archive)
+			return nullptr;
+
+		SeekableReadStream *stream = archive->createReadStreamForMember(name);
+		if (stream)
+			return stream;
+	}
+
+	// Either the name has not been looked up before, or the archive it was
+	// found in failed to open it, so fall back to trying all archives
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
-		if (stream)
+		if (stream) {
+			if (!cached)
+				_lookupCache[name] = it->_arc;
 			return stream;
+		}
 	}
 
+	if (!cached)
+		_lookupCache[name] = nullptr;
 	return nullptr;
 }
 
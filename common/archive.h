@@ -24,6 +24,8 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/array.h"
+#include "common/hash-str.h"
 #include "common/list.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
@@ -132,6 +134,11 @@ public:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet *DOES* guarantee that searches are performed in *DESCENDING*
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * The archive a name resolves to (or the lack of one) is remembered, so that
+ * repeated lookups of the same name only cost a single hash lookup. These
+ * results are discarded whenever any SearchSet is modified, which also covers
+ * SearchSets contained in other SearchSets.
  */
 class SearchSet : public Archive {
 	struct Node {
@@ -139,13 +146,35 @@ class SearchSet : public Archive {
 		String	_name;
 		Archive	*_arc;
 		bool	_autoFree;
+		SearchSet	*_set;	/**< _arc, if it is a SearchSet */
 		Node(int priority, const String &name, Archive *arc, bool autoFree)
-			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree) {
+			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree), _set(nullptr) {
 		}
 	};
 	typedef List<Node> ArchiveNodeList;
 	ArchiveNodeList _list;
 
+	/**
+	 * Maps names to the archive they were found in, or to nullptr if no
+	 * archive contains them. Names are matched caselessly, just like the
+	 * archives match them.
+	 */
+	typedef HashMap<String, Archive *, IgnoreCase_Hash, IgnoreCase_EqualTo> LookupCache;
+	mutable LookupCache _lookupCache;
+	mutable uint32 _lookupCacheStamp;
+
+	/** Bumped whenever this SearchSet or a SearchSet in it is modified. */
+	uint32 _modificationStamp;
+
+	/** The SearchSets which contain this one. */
+	Array<SearchSet *> _parents;
+
+	void invalidateLookupCache();
+	void unlinkNode(const Node &node);
+	void removeSet(SearchSet *set);
+	bool findCachedArchive(const String &name, Archive *&archive) const;
+	Archive *findArchive(const String &name) const;
+
 	ArchiveNodeList::iterator find(const String &name);
 	ArchiveNodeList::const_iterator find(const String &name) const;
 
@@ -155,8 +184,8 @@ class SearchSet : public Archive {
 	bool _ignoreClashes;
 
 public:
-	SearchSet() : _ignoreClashes(false) { }
-	virtual ~SearchSet() { clear(); }
+	SearchSet() : _lookupCacheStamp(0), _modificationStamp(0), _ignoreClashes(false) { }
+	virtual ~SearchSet();
 
 	/**
 	 * Add a new archive to the searchable set.
@@ -173,6 +202,14 @@ public:
 	 */
 	void addDirectory(const String &name, const FSNode &directory, int priority = 0, int depth = 1, bool flat = false);
 
+	/**
+	 * Create and add a FSDirectory by FSNode, which keeps its directory
+	 * listings in the persistent cache of the given name.
+	 *
+	 * @see FSDirectory::setPersistentCache
+	 */
+	void addDirectory(const String &name, const FSNode &directory, const String &cacheName, int priority = 0, int depth = 1, bool flat = false);
+
 	/**
 	 * Create and add a sub directory by name (caseless).
 	 *
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
@@ -117,6 +118,10 @@ bool FSNode::isDirectory() const {
 	return _realNode && _realNode->isDirectory();
 }
 
+uint32 FSNode::getModificationTime() const {
+	return _realNode ? _realNode->getModificationTime() : 0;
+}
+
 bool FSNode::isReadable() const {
 	return _realNode && _realNode->isReadable();
 }
@@ -169,23 +174,27 @@ bool FSNode::createDirectory() const {
 }
 
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes)
-  : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes) {
+  : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+    _listingsChanged(false), _listingTime(0) {
 }
 
 FSDirectory::FSDirectory(const String &prefix, const FSNode &node, int depth, bool flat,
                          bool ignoreClashes)
-  : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes) {
+  : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+    _listingsChanged(false), _listingTime(0) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::FSDirectory(const String &name, int depth, bool flat, bool ignoreClashes)
-  : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes) {
+  : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+    _listingsChanged(false), _listingTime(0) {
 }
 
 FSDirectory::FSDirectory(const String &prefix, const String &name, int depth, bool flat,
                          bool ignoreClashes)
-  : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes) {
+  : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
+    _listingsChanged(false), _listingTime(0) {
 
 	setPrefix(prefix);
 }
@@ -204,6 +213,11 @@ FSNode FSDirectory::getFSNode() const {
 	return _node;
 }
 
+void FSDirectory::setPersistentCache(const String &cacheName) {
+	assert(!_cached);
+	_persistentCacheName = cacheName;
+}
+
 FSNode *FSDirectory::lookupCache(NodeCache &cache, const String &name) const {
 	// make caching as lazy as possible
 	if (!name.empty()) {
@@ -211,11 +225,27 @@ FSNode *FSDirectory::lookupCache(NodeCache &cache, const String &name) const {
 
 		if (cache.contains(name))
 			return &cache[name];
+
+		if (&cache == &_fileCache) {
+			LazyNodeCache::iterator lazy = _lazyFileCache.find(name);
+			if (lazy != _lazyFileCache.end()) {
+				String key = lazy->_key;
+				FSNode &node = _fileCache[key] = lazy->_value.parent.getChild(lazy->_value.name);
+				_lazyFileCache.erase(key);
+				return &node;
+			}
+		}
 	}
 
 	return nullptr;
 }
 
+void FSDirectory::resolveLazyNodes() const {
+	for (LazyNodeCache::const_iterator it = _lazyFileCache.begin(); it != _lazyFileCache.end(); ++it)
+		_fileCache[it->_key] = it->_value.parent.getChild(it->_value.name);
+	_lazyFileCache.clear();
+}
+
 bool FSDirectory::hasFile(const String &name) const {
 	if (name.empty() || !_node.isDirectory())
 		return false;
@@ -275,61 +305,227 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String&
 	if (depth <= 0)
 		return;
 
+	if (!_persistentCacheName.empty() && cacheStoredListing(node, depth, prefix))
+		return;
+
+	// The modification time has to be read before the directory is listed,
+	// so that changes made while listing it are not missed
+	const uint32 modificationTime = _persistentCacheName.empty() ? 0 : node.getModificationTime();
+
 	FSList list;
 	node.getChildren(list, FSNode::kListAll);
 
-	FSList::iterator it = list.begin();
-	for ( ; it != list.end(); ++it) {
-		String name = prefix + it->getName();
-
-		// don't touch name as it might be used for warning messages
-		String lowercaseName = name;
-		lowercaseName.toLowercase();
-
-		// since the hashmap is case insensitive, we need to check for clashes when caching
-		if (it->isDirectory()) {
-			if (!_flat && _subDirCache.contains(lowercaseName)) {
-				// Always warn in this case as it's when there are 2 directories at the same place with different case
-				// That means a problem in user installation as lookups are always done case insensitive
-				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'",
-				        name.c_str());
-			} else {
-				if (_subDirCache.contains(lowercaseName)) {
-					if (!_ignoreClashes) {
-						warning("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'",
-						        name.c_str());
-					}
-				}
-				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : lowercaseName + "/");
-				_subDirCache[lowercaseName] = *it;
+	if (!_persistentCacheName.empty()) {
+		// Modification times only have a resolution of a second. If the
+		// directory was modified in the second the listing started in (or
+		// later), it may have been modified again after it was listed,
+		// without its modification time changing, so the listing can not
+		// be trusted in the next run
+		if (modificationTime != 0 && modificationTime < _listingTime) {
+			DirectoryListing &listing = _listings[node.getPath()];
+			listing.modificationTime = modificationTime;
+			listing.entries.resize(list.size());
+			for (uint i = 0; i < list.size(); ++i) {
+				listing.entries[i].name = list[i].getName();
+				listing.entries[i].isDirectory = list[i].isDirectory();
 			}
+			_listingsChanged = true;
+		}
+	}
+
+	FSList::iterator it = list.begin();
+	for ( ; it != list.end(); ++it)
+		cacheEntry(node, &*it, it->getName(), it->isDirectory(), depth, prefix);
+}
+
+bool FSDirectory::cacheStoredListing(const FSNode &node, int depth, const String &prefix) const {
+	const String path = node.getPath();
+	ListingCache::const_iterator stored = _storedListings.find(path);
+	if (stored == _storedListings.end())
+		return false;
+
+	// Entries are only ever added, removed or renamed by modifying the
+	// directory itself, so an unchanged modification time means that the
+	// stored listing is still accurate
+	const uint32 modificationTime = node.getModificationTime();
+	if (modificationTime == 0 || modificationTime != stored->_value.modificationTime)
+		return false;
+
+	const DirectoryListing &listing = _listings[path] = stored->_value;
+	for (uint i = 0; i < listing.entries.size(); ++i)
+		cacheEntry(node, nullptr, listing.entries[i].name, listing.entries[i].isDirectory, depth, prefix);
+
+	return true;
+}
+
+void FSDirectory::cacheEntry(const FSNode &parent, const FSNode *node, const String &entryName, bool isDirectory,
+                             int depth, const String &prefix) const {
+	String name = prefix + entryName;
+
+	// don't touch name as it might be used for warning messages
+	String lowercaseName = name;
+	lowercaseName.toLowercase();
+
+	// since the hashmap is case insensitive, we need to check for clashes when caching
+	if (isDirectory) {
+		if (!_flat && _subDirCache.contains(lowercaseName)) {
+			// Always warn in this case as it's when there are 2 directories at the same place with different case
+			// That means a problem in user installation as lookups are always done case insensitive
+			warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'",
+			        name.c_str());
 		} else {
-			if (_fileCache.contains(lowercaseName)) {
+			if (_subDirCache.contains(lowercaseName)) {
 				if (!_ignoreClashes) {
-					warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'",
+					warning("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'",
 					        name.c_str());
 				}
-			} else {
-				_fileCache[lowercaseName] = *it;
 			}
+			FSNode subDir = node ? *node : parent.getChild(entryName);
+			cacheDirectoryRecursive(subDir, depth - 1, _flat ? prefix : lowercaseName + "/");
+			_subDirCache[lowercaseName] = subDir;
+		}
+	} else {
+		if (_fileCache.contains(lowercaseName) || _lazyFileCache.contains(lowercaseName)) {
+			if (!_ignoreClashes) {
+				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'",
+				        name.c_str());
+			}
+		} else if (node) {
+			_fileCache[lowercaseName] = *node;
+		} else {
+			LazyNode &lazy = _lazyFileCache[lowercaseName];
+			lazy.parent = parent;
+			lazy.name = entryName;
 		}
 	}
-
 }
 
 void FSDirectory::ensureCached() const  {
 	if (_cached)
 		return;
+
+	if (!_persistentCacheName.empty()) {
+		_listingTime = g_system->getFilesystemFactory()->getCurrentTime();
+		loadPersistentCache();
+	}
+
 	cacheDirectoryRecursive(_node, _depth, _prefix);
+
+	if (!_persistentCacheName.empty()) {
+		// Also rewrite the cache when directories have disappeared
+		if (_listingsChanged || _listings.size() != _storedListings.size())
+			savePersistentCache();
+		_storedListings.clear();
+		_listings.clear();
+	}
+
 	_cached = true;
 }
 
+namespace {
+
+enum {
+	kPersistentCacheVersion = 1
+};
+
+void writeCacheString(WriteStream *stream, const String &str) {
+	stream->writeUint32LE(str.size());
+	stream->write(str.c_str(), str.size());
+}
+
+String readCacheString(SeekableReadStream *stream) {
+	uint32 size = stream->readUint32LE();
+	if (stream->err() || stream->eos() || size > (uint32)(stream->size() - stream->pos()))
+		return String();
+
+	String str;
+	for (uint32 i = 0; i < size; ++i)
+		str += (char)stream->readByte();
+	return str;
+}
+
+} // End of anonymous namespace
+
+FSNode FSDirectory::getPersistentCacheFile() const {
+	const String cachePath = g_system->getCachePath();
+	if (cachePath.empty())
+		return FSNode();
+
+	const FSNode cacheDir(cachePath);
+	if (!cacheDir.isDirectory())
+		return FSNode();
+	return cacheDir.getChild(_persistentCacheName);
+}
+
+void FSDirectory::loadPersistentCache() const {
+	const FSNode file = getPersistentCacheFile();
+	if (!file.exists())
+		return;
+
+	ScopedPtr<SeekableReadStream> in(file.createReadStream());
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != MKTAG('F', 'S', 'D', 'C') || in->readUint32LE() != kPersistentCacheVersion)
+		return;
+
+	// The same cache name may have been used for a different tree
+	if (readCacheString(in.get()) != _node.getPath())
+		return;
+
+	uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && !in->err() && !in->eos(); ++i) {
+		String path = readCacheString(in.get());
+		DirectoryListing &listing = _storedListings[path];
+		listing.modificationTime = in->readUint32LE();
+
+		uint32 entries = in->readUint32LE();
+		for (uint32 j = 0; j < entries && !in->err() && !in->eos(); ++j) {
+			DirectoryListing::Entry entry;
+			entry.name = readCacheString(in.get());
+			entry.isDirectory = in->readByte() != 0;
+			listing.entries.push_back(entry);
+		}
+	}
+
+	if (in->err() || in->eos()) {
+		warning("FSDirectory::loadPersistentCache: '%s' is corrupt, ignoring it", _persistentCacheName.c_str());
+		_storedListings.clear();
+	}
+}
+
+void FSDirectory::savePersistentCache() const {
+	ScopedPtr<WriteStream> out(getPersistentCacheFile().createWriteStream());
+	if (!out)
+		return;
+
+	out->writeUint32BE(MKTAG('F', 'S', 'D', 'C'));
+	out->writeUint32LE(kPersistentCacheVersion);
+	writeCacheString(out.get(), _node.getPath());
+
+	out->writeUint32LE(_listings.size());
+	for (ListingCache::const_iterator it = _listings.begin(); it != _listings.end(); ++it) {
+		writeCacheString(out.get(), it->_key);
+		out->writeUint32LE(it->_value.modificationTime);
+		out->writeUint32LE(it->_value.entries.size());
+		for (uint i = 0; i < it->_value.entries.size(); ++i) {
+			writeCacheString(out.get(), it->_value.entries[i].name);
+			out->writeByte(it->_value.entries[i].isDirectory ? 1 : 0);
+		}
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("FSDirectory::savePersistentCache: Could not write '%s'", _persistentCacheName.c_str());
+}
+
 int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
 	if (!_node.isDirectory())
 		return 0;
 
 	// Cache dir data
 	ensureCached();
+	resolveLazyNodes();
 
 	// need to match lowercase key, since all entries in our file cache are
 	// stored as lowercase.
@@ -353,6 +549,7 @@ int FSDirectory::listMembers(ArchiveMemberList &list) const {
 
 	// Cache dir data
 	ensureCached();
+	resolveLazyNodes();
 
 	int files = 0;
 	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it) {
@@ -187,6 +187,13 @@ public:
 	 */
 	bool isDirectory() const;
 
+	/**
+	 * Returns the time the node was last modified, in seconds since an
+	 * arbitrary (but fixed) epoch, or 0 if that is not known. Only the
+	 * comparison of two such values is meaningful.
+	 */
+	uint32 getModificationTime() const;
+
 	/**
 	 * Indicates whether the object referred by this node can be read from or not.
 	 *
@@ -280,6 +287,11 @@ public:
  * and using 'your' as prefix, the cache entry would have been 'your/data/file.ext'.
  * This is done both in non-flat and flat mode.
  *
+ * Listing a large tree can be slow, so the directory listings can be kept in
+ * a persistent cache using setPersistentCache(). Later instances on the same
+ * tree then only list the directories whose modification time changed, and
+ * only look up the nodes of the files which are actually accessed.
+ *
  */
 class FSDirectory : public Archive {
 	FSNode _node;
@@ -296,11 +308,50 @@ class FSDirectory : public Archive {
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable bool _cached;
 
+	// Files restored from the persistent cache, whose nodes are only created
+	// when they are looked up
+	struct LazyNode {
+		FSNode parent;
+		String name;
+	};
+	typedef HashMap<String, LazyNode, IgnoreCase_Hash, IgnoreCase_EqualTo> LazyNodeCache;
+	mutable LazyNodeCache _lazyFileCache;
+
+	// Contents of a single directory, as kept in the persistent cache.
+	// Keyed by the path of the directory.
+	struct DirectoryListing {
+		struct Entry {
+			String name;
+			bool isDirectory;
+		};
+
+		uint32 modificationTime;
+		Array<Entry> entries;
+	};
+	typedef HashMap<String, DirectoryListing> ListingCache;
+
+	String _persistentCacheName;
+	mutable ListingCache _storedListings, _listings;
+	mutable bool _listingsChanged;
+	// Time the listing of the tree started, see cacheDirectoryRecursive()
+	mutable uint32 _listingTime;
+
 	// look for a match
 	FSNode *lookupCache(NodeCache &cache, const String &name) const;
 
+	// create the nodes of all lazily cached files
+	void resolveLazyNodes() const;
+
 	// cache management
 	void cacheDirectoryRecursive(FSNode node, int depth, const String& prefix) const;
+	bool cacheStoredListing(const FSNode &node, int depth, const String &prefix) const;
+	void cacheEntry(const FSNode &parent, const FSNode *node, const String &entryName, bool isDirectory,
+	                int depth, const String &prefix) const;
+
+	// persistent cache management
+	FSNode getPersistentCacheFile() const;
+	void loadPersistentCache() const;
+	void savePersistentCache() const;
 
 	// fill cache if not already cached
 	void ensureCached() const;
@@ -332,6 +383,17 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * Keep the directory listings of this tree in the file with the given
+	 * name in the cache directory (see OSystem::getCachePath()), and reuse
+	 * them for directories which have not been modified since. Has to be
+	 * called before the first lookup.
+	 *
+	 * This only pays off on backends which report modification times and
+	 * have a cache directory, on others every directory is still listed.
+	 */
+	void setPersistentCache(const String &cacheName);
+
 	/**
 	 * Create a new FSDirectory pointing to a sub directory of the instance. See class comment
 	 * for an explanation of the prefix parameter.
@@ -23,6 +23,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
 #include "common/savefile.h"
@@ -197,6 +198,10 @@ Common::String OSystem::getDefaultConfigFileName() {
 	return "scummvm.ini";
 }
 
+Common::String OSystem::getCachePath() {
+	return ConfMan.get("cachepath");
+}
+
 Common::String OSystem::getSystemLanguage() const {
 	return "en_US";
 }
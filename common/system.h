@@ -1408,6 +1408,15 @@ public:
 	 */
 	virtual Common::String getDefaultConfigFileName();
 
+	/**
+	 * Get the path of the directory where files which can be recreated at
+	 * any time, like caches, are kept. Returns an empty string if there is
+	 * no such directory.
+	 *
+	 * The default implementation returns the "cachepath" config option.
+	 */
+	virtual Common::String getCachePath();
+
 	/**
 	 * Logs a given message.
 	 *
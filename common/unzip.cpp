@@ -106,6 +106,10 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/bufferedstream.h"
+#include "common/ptr.h"
+#include "common/array.h"
+#include "common/textconsole.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -382,6 +386,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owner of _stream, shared with member streams */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -544,6 +549,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +601,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -605,6 +610,10 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	us->central_pos = central_pos;
 	us->pfile_in_zip_read = nullptr;
 
+	// Walking the central directory consists of lots of small reads and
+	// short seeks, so let a buffered view of the archive serve them
+	us->_stream = Common::wrapBufferedSeekableReadStream(stream, UNZ_BUFSIZE, DisposeAfterUse::NO);
+
 	err = unzGoToFirstFile((unzFile)us);
 
 	while (err == UNZ_OK) {
@@ -626,6 +635,10 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		// Move to the next file
 		err = unzGoToNextFile((unzFile)us);
 	}
+
+	delete us->_stream;
+	us->_stream = stream;
+
 	return (unzFile)us;
 }
 
@@ -644,7 +657,6 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -945,15 +957,19 @@ int unzLocateFile(unzFile file, const char *szFileName, int iCaseSensitivity) {
 
 
 /*
-  Read the local header of the current zipfile
+  Read the local header of the given file in the zipfile
   Check the coherency of the local header and info in the end of central
         directory about this file
   store in *piSizeVar the size of extra info in local header
         (filename and size of extra field data)
 */
-static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s* s, uInt* piSizeVar,
-													uLong *poffset_local_extrafield,
-													uInt  *psize_local_extrafield) {
+static int unzlocal_CheckFileCoherencyHeader(Common::SeekableReadStream *stream,
+											 uLong byte_before_the_zipfile,
+											 const unz_file_info *pfile_info,
+											 const unz_file_info_internal *pfile_info_internal,
+											 uInt* piSizeVar,
+											 uLong *poffset_local_extrafield,
+											 uInt  *psize_local_extrafield) {
 	uLong uMagic,uData,uFlags;
 	uLong size_filename;
 	uLong size_extra_field;
@@ -963,69 +979,69 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s* s, uInt* piSizeVar,
 	*poffset_local_extrafield = 0;
 	*psize_local_extrafield = 0;
 
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile +
-								s->byte_before_the_zipfile, SEEK_SET);
-	if (s->_stream->err())
+	stream->seek(pfile_info_internal->offset_curfile +
+								byte_before_the_zipfile, SEEK_SET);
+	if (stream->err())
 		return UNZ_ERRNO;
 
 
 	if (err==UNZ_OK) {
-		if (unzlocal_getLong(s->_stream,&uMagic) != UNZ_OK)
+		if (unzlocal_getLong(stream,&uMagic) != UNZ_OK)
 			err=UNZ_ERRNO;
 		else if (uMagic!=0x04034b50)
 			err=UNZ_BADZIPFILE;
 	}
 
-	if (unzlocal_getShort(s->_stream,&uData) != UNZ_OK)
+	if (unzlocal_getShort(stream,&uData) != UNZ_OK)
 		err=UNZ_ERRNO;
 /*
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.wVersion))
+	else if ((err==UNZ_OK) && (uData!=pfile_info->wVersion))
 		err=UNZ_BADZIPFILE;
 */
-	if (unzlocal_getShort(s->_stream,&uFlags) != UNZ_OK)
+	if (unzlocal_getShort(stream,&uFlags) != UNZ_OK)
 		err=UNZ_ERRNO;
 
-	if (unzlocal_getShort(s->_stream,&uData) != UNZ_OK)
+	if (unzlocal_getShort(stream,&uData) != UNZ_OK)
 		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.compression_method))
+	else if ((err==UNZ_OK) && (uData!=pfile_info->compression_method))
 		err=UNZ_BADZIPFILE;
 
-	if ((err==UNZ_OK) && (s->cur_file_info.compression_method!=0) &&
-	                     (s->cur_file_info.compression_method!=Z_DEFLATED))
+	if ((err==UNZ_OK) && (pfile_info->compression_method!=0) &&
+	                     (pfile_info->compression_method!=Z_DEFLATED))
 		err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getLong(s->_stream,&uData) != UNZ_OK) /* date/time */
+	if (unzlocal_getLong(stream,&uData) != UNZ_OK) /* date/time */
 		err=UNZ_ERRNO;
 
-	if (unzlocal_getLong(s->_stream,&uData) != UNZ_OK) /* crc */
+	if (unzlocal_getLong(stream,&uData) != UNZ_OK) /* crc */
 		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.crc) &&
+	else if ((err==UNZ_OK) && (uData!=pfile_info->crc) &&
 		                      ((uFlags & 8)==0))
 		err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getLong(s->_stream,&uData) != UNZ_OK) /* size compr */
+	if (unzlocal_getLong(stream,&uData) != UNZ_OK) /* size compr */
 		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.compressed_size) &&
+	else if ((err==UNZ_OK) && (uData!=pfile_info->compressed_size) &&
 							  ((uFlags & 8)==0))
 		err=UNZ_BADZIPFILE;
 
-	if (unzlocal_getLong(s->_stream,&uData) != UNZ_OK) /* size uncompr */
+	if (unzlocal_getLong(stream,&uData) != UNZ_OK) /* size uncompr */
 		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (uData!=s->cur_file_info.uncompressed_size) &&
+	else if ((err==UNZ_OK) && (uData!=pfile_info->uncompressed_size) &&
 							  ((uFlags & 8)==0))
 		err=UNZ_BADZIPFILE;
 
 
-	if (unzlocal_getShort(s->_stream,&size_filename) != UNZ_OK)
+	if (unzlocal_getShort(stream,&size_filename) != UNZ_OK)
 		err=UNZ_ERRNO;
-	else if ((err==UNZ_OK) && (size_filename!=s->cur_file_info.size_filename))
+	else if ((err==UNZ_OK) && (size_filename!=pfile_info->size_filename))
 		err=UNZ_BADZIPFILE;
 
 	*piSizeVar += (uInt)size_filename;
 
-	if (unzlocal_getShort(s->_stream,&size_extra_field) != UNZ_OK)
+	if (unzlocal_getShort(stream,&size_extra_field) != UNZ_OK)
 		err=UNZ_ERRNO;
-	*poffset_local_extrafield= s->cur_file_info_internal.offset_curfile +
+	*poffset_local_extrafield= pfile_info_internal->offset_curfile +
 									SIZEZIPLOCALHEADER + size_filename;
 	*psize_local_extrafield = (uInt)size_extra_field;
 
@@ -1056,7 +1072,8 @@ int unzOpenCurrentFile (unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
+	if (unzlocal_CheckFileCoherencyHeader(s->_stream,s->byte_before_the_zipfile,
+				&s->cur_file_info,&s->cur_file_info_internal,&iSizeVar,
 				&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
 		return UNZ_BADZIPFILE;
 
@@ -1419,13 +1436,334 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * A read stream over a single member of a ZIP archive, which reads the data
+ * on demand instead of extracting the whole member into memory first.
+ *
+ * Stored members are read straight from the archive stream. Deflated members
+ * are inflated on the fly; every so often a copy of the inflate state is kept
+ * as a checkpoint, so that seeking backwards only has to re-inflate the data
+ * following the nearest checkpoint instead of the whole member.
+ *
+ * Each member stream gets its own handle to the archive file, so several of
+ * them may be used at the same time, even from different threads. Members of
+ * archives opened from a stream are extracted into memory instead, as they
+ * could only share (and keep repositioning) that stream.
+ */
+class ZipMemberReadStream : public SeekableReadStream {
+protected:
+	enum {
+		BUFSIZE = UNZ_BUFSIZE,
+		// Every checkpoint holds a complete inflate state, including its
+		// 32 KB window. The distance between checkpoints therefore grows
+		// with the member size, so that there are never more than
+		// MAX_CHECKPOINTS of them.
+		MIN_CHECKPOINT_INTERVAL = 1024 * 1024,
+		MAX_CHECKPOINTS = 64
+	};
+
+	SharedPtr<SeekableReadStream> _parent;
+	uint32 _dataStart;
+	uint32 _compressedSize;
+	uint32 _uncompressedSize;
+	bool _deflated;
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+#ifdef USE_ZLIB
+	struct Checkpoint {
+		uint32 outPos;		///< position in the uncompressed data
+		uint32 inPos;		///< position in the compressed data
+		z_stream state;		///< copy of the inflate state at this point
+	};
+
+	byte *_buf;
+	z_stream _stream;
+	bool _streamInitialized;
+	uint32 _inPos;
+	uint32 _checkpointInterval;
+	// zlib keeps a pointer back to each z_stream, so they must not move
+	Array<Checkpoint *> _checkpoints;
+
+	uLong _crc;
+	uLong _expectedCrc;
+	bool _crcValid;
+
+	uint32 inflateData(byte *dst, uint32 len);
+	Checkpoint *findCheckpoint(uint32 pos);
+	void restartFrom(Checkpoint *checkpoint);
+#endif
+
+	uint32 readStored(byte *dst, uint32 len);
+
+public:
+	ZipMemberReadStream(const SharedPtr<SeekableReadStream> &parent, uint32 dataStart,
+	                    uint32 compressedSize, uint32 uncompressedSize, bool deflated, uint32 crc);
+	~ZipMemberReadStream();
+
+	bool err() const { return _err; }
+	void clearErr() {
+		// only reset _eos; I/O errors are not recoverable
+		_eos = false;
+	}
+	bool eos() const { return _eos; }
+
+	int32 pos() const { return _pos; }
+	int32 size() const { return _uncompressedSize; }
+	bool seek(int32 offset, int whence = SEEK_SET);
+
+	uint32 read(void *dataPtr, uint32 dataSize);
+};
+
+ZipMemberReadStream::ZipMemberReadStream(const SharedPtr<SeekableReadStream> &parent, uint32 dataStart,
+                                         uint32 compressedSize, uint32 uncompressedSize, bool deflated, uint32 crc)
+	: _parent(parent), _dataStart(dataStart), _compressedSize(compressedSize),
+	  _uncompressedSize(uncompressedSize), _deflated(deflated), _pos(0), _eos(false), _err(false) {
+	assert(_parent);
+
+#ifdef USE_ZLIB
+	_buf = nullptr;
+	memset(&_stream, 0, sizeof(_stream));
+	_streamInitialized = false;
+	_inPos = 0;
+	_checkpointInterval = MAX<uint32>(MIN_CHECKPOINT_INTERVAL, _uncompressedSize / MAX_CHECKPOINTS + 1);
+	_crc = 0;
+	_expectedCrc = crc;
+	_crcValid = true;
+
+	if (_deflated) {
+		_buf = new byte[BUFSIZE];
+		// windowBits is passed < 0 to tell that there is no zlib header
+		_streamInitialized = (inflateInit2(&_stream, -MAX_WBITS) == Z_OK);
+		_err = !_streamInitialized;
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+	}
+#else
+	// Deflated data cannot be read without zlib
+	_err = _deflated;
+#endif
+}
+
+ZipMemberReadStream::~ZipMemberReadStream() {
+#ifdef USE_ZLIB
+	for (uint i = 0; i < _checkpoints.size(); ++i) {
+		inflateEnd(&_checkpoints[i]->state);
+		delete _checkpoints[i];
+	}
+	if (_streamInitialized)
+		inflateEnd(&_stream);
+	delete[] _buf;
+#endif
+}
+
+uint32 ZipMemberReadStream::readStored(byte *dst, uint32 len) {
+	if (!_parent->seek(_dataStart + _pos, SEEK_SET)) {
+		_err = true;
+		return 0;
+	}
+
+	uint32 actual = _parent->read(dst, len);
+	if (_parent->err())
+		_err = true;
+	_pos += actual;
+	return actual;
+}
+
+#ifdef USE_ZLIB
+
+uint32 ZipMemberReadStream::inflateData(byte *dst, uint32 len) {
+	uint32 total = 0;
+
+	while (len > 0 && !_err) {
+		uint32 nextCheckpoint = (_checkpoints.size() + 1) * _checkpointInterval;
+		if (_pos >= nextCheckpoint) {
+			Checkpoint *checkpoint = new Checkpoint();
+			checkpoint->outPos = _pos;
+			checkpoint->inPos = _inPos - _stream.avail_in;
+			if (inflateCopy(&checkpoint->state, &_stream) == Z_OK)
+				_checkpoints.push_back(checkpoint);
+			else
+				delete checkpoint;
+			nextCheckpoint = _pos + _checkpointInterval;
+		}
+
+		if (_stream.avail_in == 0) {
+			if (_inPos >= _compressedSize)
+				break;
+
+			uint32 toRead = MIN<uint32>(BUFSIZE, _compressedSize - _inPos);
+			if (!_parent->seek(_dataStart + _inPos, SEEK_SET) || _parent->read(_buf, toRead) != toRead) {
+				_err = true;
+				break;
+			}
+			_inPos += toRead;
+			_stream.next_in = _buf;
+			_stream.avail_in = toRead;
+		}
+
+		// Never inflate past the next checkpoint in one go, so that it
+		// can be taken at the right position
+		uint32 chunk = MIN(len, nextCheckpoint - _pos);
+		_stream.next_out = dst;
+		_stream.avail_out = chunk;
+
+		int zlibErr = inflate(&_stream, Z_SYNC_FLUSH);
+
+		uint32 produced = chunk - _stream.avail_out;
+		if (_crcValid)
+			_crc = crc32(_crc, dst, produced);
+		_pos += produced;
+		dst += produced;
+		len -= produced;
+		total += produced;
+
+		if (zlibErr == Z_STREAM_END)
+			break;
+		if (zlibErr != Z_OK) {
+			// Z_BUF_ERROR only means that the compressed data ended early
+			if (zlibErr != Z_BUF_ERROR)
+				_err = true;
+			break;
+		}
+	}
+
+	if (_crcValid && _pos == _uncompressedSize) {
+		if (_crc != _expectedCrc) {
+			warning("ZipMemberReadStream: CRC mismatch");
+			_err = true;
+		}
+		_crcValid = false;
+	}
+
+	return total;
+}
+
+ZipMemberReadStream::Checkpoint *ZipMemberReadStream::findCheckpoint(uint32 pos) {
+	Checkpoint *found = nullptr;
+	for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= pos; ++i)
+		found = _checkpoints[i];
+	return found;
+}
+
+void ZipMemberReadStream::restartFrom(Checkpoint *checkpoint) {
+	if (checkpoint) {
+		inflateEnd(&_stream);
+		_streamInitialized = (inflateCopy(&_stream, &checkpoint->state) == Z_OK);
+		_inPos = checkpoint->inPos;
+		_pos = checkpoint->outPos;
+		// The checksum can only be verified when reading from the start
+		_crcValid = false;
+	} else {
+		_streamInitialized = (inflateReset(&_stream) == Z_OK);
+		_inPos = 0;
+		_pos = 0;
+		_crc = 0;
+		_crcValid = true;
+	}
+
+	if (!_streamInitialized)
+		_err = true;
+	_stream.next_in = _buf;
+	_stream.avail_in = 0;
+}
+
+#endif
+
+bool ZipMemberReadStream::seek(int32 offset, int whence) {
+	int32 newPos = 0;
+	switch (whence) {
+	default:
+		// fallthrough intended
+	case SEEK_SET:
+		newPos = offset;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offset;
+		break;
+	case SEEK_END:
+		newPos = _uncompressedSize + offset;
+		break;
+	}
+
+	if (newPos < 0 || (uint32)newPos > _uncompressedSize)
+		return false;
+
+	if (!_deflated) {
+		_pos = newPos;
+		_eos = false;
+		return true;
+	}
+
+#ifdef USE_ZLIB
+	// Go back to the nearest checkpoint, unless inflating from the current
+	// position is the shorter way to the target
+	Checkpoint *checkpoint = findCheckpoint(newPos);
+	if ((uint32)newPos < _pos || (checkpoint && checkpoint->outPos > _pos))
+		restartFrom(checkpoint);
+
+	byte tmpBuf[1024];
+	while (!_err && _pos < (uint32)newPos) {
+		if (inflateData(tmpBuf, MIN<uint32>(sizeof(tmpBuf), newPos - _pos)) == 0)
+			break;
+	}
+
+	_eos = false;
+	return !_err && _pos == (uint32)newPos;
+#else
+	return false;
+#endif
+}
+
+uint32 ZipMemberReadStream::read(void *dataPtr, uint32 dataSize) {
+	if (_err)
+		return 0;
+
+	if (dataSize > _uncompressedSize - _pos) {
+		dataSize = _uncompressedSize - _pos;
+		_eos = true;
+	}
+
+	if (dataSize == 0)
+		return 0;
+
+	uint32 actual;
+#ifdef USE_ZLIB
+	if (_deflated)
+		actual = inflateData((byte *)dataPtr, dataSize);
+	else
+#endif
+		actual = readStored((byte *)dataPtr, dataSize);
+
+	if (actual < dataSize)
+		_eos = true;
+	return actual;
+}
+
+
+/**
+ * Deflated members up to this size are extracted into memory when opened,
+ * larger ones are streamed.
+ */
+static const uint32 kZipInflateInMemorySize = 64 * 1024;
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
 
+	/**
+	 * The node the archive was opened from, if any. Streamed members open
+	 * their own handle to it, so they do not have to share (and keep
+	 * repositioning) the archive stream.
+	 */
+	FSNode _node;
+	bool _hasNode;
+
+	SeekableReadStream *openMemberStream(const cached_file_in_zip &entry, const SharedPtr<SeekableReadStream> &parent) const;
+
 public:
 	ZipArchive(unzFile zipFile);
-
+	ZipArchive(unzFile zipFile, const FSNode &node);
 
 	~ZipArchive();
 
@@ -1453,7 +1791,11 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
+ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile), _hasNode(false) {
+	assert(_zipFile);
+}
+
+ZipArchive::ZipArchive(unzFile zipFile, const FSNode &node) : _zipFile(zipFile), _node(node), _hasNode(true) {
 	assert(_zipFile);
 }
 
@@ -1462,7 +1804,8 @@ ZipArchive::~ZipArchive() {
 }
 
 bool ZipArchive::hasFile(const String &name) const {
-	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	return archive->_hash.contains(name);
 }
 
 int ZipArchive::listMembers(ArchiveMemberList &list) const {
@@ -1485,36 +1828,64 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 	return ArchiveMemberPtr(new GenericArchiveMember(name, this));
 }
 
-SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
-	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
+SeekableReadStream *ZipArchive::openMemberStream(const cached_file_in_zip &entry, const SharedPtr<SeekableReadStream> &parent) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	const unz_file_info &fileInfo = entry.cur_file_info;
+
+	// Check the local header and find out where the member data starts
+	uInt sizeVar;
+	uLong offsetExtraField;
+	uInt sizeExtraField;
+	if (unzlocal_CheckFileCoherencyHeader(parent.get(), archive->byte_before_the_zipfile,
+			&fileInfo, &entry.cur_file_info_internal, &sizeVar, &offsetExtraField, &sizeExtraField) != UNZ_OK)
 		return nullptr;
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
-		return nullptr;
+	return new ZipMemberReadStream(parent,
+		entry.cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + sizeVar + archive->byte_before_the_zipfile,
+		fileInfo.compressed_size, fileInfo.uncompressed_size,
+		fileInfo.compression_method == Z_DEFLATED, fileInfo.crc);
+}
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	ZipHash::const_iterator i = archive->_hash.find(name);
+	if (i == archive->_hash.end())
 		return nullptr;
 
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
-
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
+	const unz_file_info &fileInfo = i->_value.cur_file_info;
+	if (fileInfo.compression_method != 0 && fileInfo.compression_method != Z_DEFLATED)
 		return nullptr;
-	}
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
-		return nullptr;
-	}
+	// Give streamed members their own handle to the archive file, so that
+	// reading them does not interfere with other streams
+	SharedPtr<SeekableReadStream> parent;
+	if (_hasNode && !(fileInfo.compression_method == Z_DEFLATED && fileInfo.uncompressed_size <= kZipInflateInMemorySize))
+		parent = SharedPtr<SeekableReadStream>(_node.createReadStream());
+
+	// Small compressed members are cheaper to inflate in one go than to
+	// keep an inflate state and read buffer around for. Members of
+	// archives opened from a stream are extracted as well, as they would
+	// otherwise all share (and keep repositioning) the archive stream.
+	if (!parent) {
+		SeekableReadStream *stream = openMemberStream(i->_value, archive->_streamRef);
+		if (!stream)
+			return nullptr;
+
+		byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
+		assert(buffer);
+
+		bool success = (stream->read(buffer, fileInfo.uncompressed_size) == fileInfo.uncompressed_size) && !stream->err();
+		delete stream;
+
+		if (!success) {
+			free(buffer);
+			return nullptr;
+		}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+		return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	}
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	return openMemberStream(i->_value, parent);
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -1522,7 +1893,16 @@ Archive *makeZipArchive(const String &name) {
 }
 
 Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
+	SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return nullptr;
+	unzFile zipFile = unzOpen(stream);
+	if (!zipFile) {
+		// stream gets deleted by unzOpen() call if something
+		// goes wrong.
+		return nullptr;
+	}
+	return new ZipArchive(zipFile, node);
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream) {
@@ -376,16 +376,22 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 			return true;
 	}
 
-	if (!allFiles.contains(fname))
+	FileMap::const_iterator file = allFiles.find(fname);
+	if (file == allFiles.end())
 		return false;
 
+	// Other engines are likely to look at the same file
+	if (FilePropsCache.lookup(file->_value, _md5Bytes, fileProps))
+		return true;
+
 	Common::File testFile;
 
-	if (!testFile.open(allFiles[fname]))
+	if (!testFile.open(file->_value))
 		return false;
 
 	fileProps.size = (int32)testFile.size();
 	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	FilePropsCache.store(file->_value, _md5Bytes, fileProps);
 	return true;
 }
 
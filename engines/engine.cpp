@@ -194,6 +194,13 @@ Engine::~Engine() {
 }
 
 void Engine::initializePath(const Common::FSNode &gamePath) {
+	if (ConfMan.getBool("fs_cache")) {
+		// Remember the directory listings between runs, so that games with
+		// many files do not need to rescan them on every start
+		SearchMan.addDirectory(gamePath.getPath(), gamePath, ConfMan.getActiveDomainName() + ".fscache", 0, 4);
+		return;
+	}
+
 	SearchMan.addDirectory(gamePath.getPath(), gamePath, 0, 4);
 }
 
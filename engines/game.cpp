@@ -21,9 +21,18 @@
  */
 
 #include "engines/game.h"
+#include "common/algorithm.h"
+#include "common/config-manager.h"
+#include "common/fs.h"
 #include "common/gui_options.h"
+#include "common/stream.h"
+#include "common/system.h"
 #include "common/translation.h"
 
+namespace Common {
+DECLARE_SINGLETON(FilePropertiesCache);
+}
+
 
 const PlainGameDescriptor *findPlainGameDescriptor(const char *gameid, const PlainGameDescriptor *list) {
 	const PlainGameDescriptor *g = list;
@@ -235,3 +244,208 @@ Common::String generateUnknownGameReport(const DetectedGame &detectedGame, bool
 
 	return generateUnknownGameReport(detectedGames, translate, fullPath, wordwrapAt);
 }
+
+namespace {
+
+const char *const kFilePropertiesCacheName = "detection.cache";
+
+enum {
+	kFilePropertiesCacheVersion = 2,
+	kFilePropertiesCacheMaxEntries = 16384
+};
+
+Common::FSNode getCacheFile() {
+	const Common::String cachePath = g_system->getCachePath();
+	if (cachePath.empty())
+		return Common::FSNode();
+
+	const Common::FSNode cacheDir(cachePath);
+	if (!cacheDir.isDirectory())
+		return Common::FSNode();
+	return cacheDir.getChild(kFilePropertiesCacheName);
+}
+
+void writeCacheString(Common::WriteStream *stream, const Common::String &str) {
+	stream->writeUint32LE(str.size());
+	stream->writeString(str);
+}
+
+bool readCacheString(Common::SeekableReadStream *stream, Common::String &str) {
+	uint32 size = stream->readUint32LE();
+	if (stream->err() || stream->eos() || size > (uint32)(stream->size() - stream->pos()))
+		return false;
+
+	str.clear();
+	for (uint32 i = 0; i < size; ++i)
+		str += (char)stream->readByte();
+	return true;
+}
+
+} // End of anonymous namespace
+
+FilePropertiesCache::FilePropertiesCache()
+	: _scanDepth(0), _loaded(false), _dirty(false), _hits(0), _misses(0) {
+}
+
+void FilePropertiesCache::beginScan() {
+	if (_scanDepth++ == 0 && !_loaded) {
+		_loaded = true;
+		if (ConfMan.getBool("detection_cache"))
+			load();
+	}
+}
+
+void FilePropertiesCache::endScan() {
+	assert(_scanDepth > 0);
+	if (--_scanDepth != 0)
+		return;
+
+	// Without a modification time there is no way to tell whether a file
+	// changed, so such entries only live as long as the scan
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->_value.modificationTime == 0)
+			_entries.erase(it);
+	}
+
+	if (_dirty && ConfMan.getBool("detection_cache"))
+		save();
+	_dirty = false;
+}
+
+Common::String FilePropertiesCache::makeKey(const Common::FSNode &node, uint32 md5Bytes) {
+	return Common::String::format("%u:", md5Bytes) + node.getPath();
+}
+
+bool FilePropertiesCache::lookup(const Common::FSNode &node, uint32 md5Bytes, FileProperties &fileProps) {
+	if (_scanDepth == 0)
+		return false;
+
+	EntryMap::iterator it = _entries.find(makeKey(node, md5Bytes));
+	if (it == _entries.end() ||
+	    (it->_value.modificationTime != 0 && it->_value.modificationTime != node.getModificationTime())) {
+		++_misses;
+		return false;
+	}
+
+	++_hits;
+	it->_value.used = true;
+	fileProps = it->_value.fileProps;
+	return true;
+}
+
+void FilePropertiesCache::store(const Common::FSNode &node, uint32 md5Bytes, const FileProperties &fileProps) {
+	if (_scanDepth == 0)
+		return;
+
+	Entry &entry = _entries[makeKey(node, md5Bytes)];
+	entry.modificationTime = node.getModificationTime();
+	entry.used = true;
+	entry.fileProps = fileProps;
+	if (entry.modificationTime != 0)
+		_dirty = true;
+}
+
+void FilePropertiesCache::load() {
+	const Common::FSNode file = getCacheFile();
+	if (!file.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> in(file.createReadStream());
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != MKTAG('D', 'C', 'H', 'E') || in->readUint32LE() != kFilePropertiesCacheVersion)
+		return;
+
+	uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count; ++i) {
+		Common::String key;
+		Entry entry;
+		if (!readCacheString(in.get(), key))
+			break;
+		entry.modificationTime = in->readUint32LE();
+		entry.age = in->readUint32LE();
+		entry.fileProps.size = in->readSint32LE();
+		if (!readCacheString(in.get(), entry.fileProps.md5))
+			break;
+		_entries[key] = entry;
+	}
+
+	if (in->err() || in->eos()) {
+		warning("FilePropertiesCache::load: '%s' is corrupt, ignoring it", kFilePropertiesCacheName);
+		_entries.clear();
+	}
+}
+
+namespace {
+
+struct EntryAge {
+	Common::String key;
+	uint32 age;
+};
+
+struct OlderEntry {
+	bool operator()(const EntryAge &a, const EntryAge &b) const { return a.age > b.age; }
+};
+
+} // End of anonymous namespace
+
+void FilePropertiesCache::prune() {
+	// Entries used since the last save were checked against their file just
+	// now. All others belong to files which were not looked at, and may be
+	// gone or modified since.
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		Entry &entry = it->_value;
+		if (entry.used) {
+			entry.used = false;
+			entry.age = 0;
+			continue;
+		}
+
+		++entry.age;
+		const Common::String path = it->_key.c_str() + it->_key.findFirstOf(':') + 1;
+		const Common::FSNode node(path);
+		if (!node.exists() || node.getModificationTime() != entry.modificationTime)
+			_entries.erase(it);
+	}
+
+	if (_entries.size() <= kFilePropertiesCacheMaxEntries)
+		return;
+
+	// Drop the entries which went unused the longest
+	Common::Array<EntryAge> ages;
+	ages.reserve(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		EntryAge age;
+		age.key = it->_key;
+		age.age = it->_value.age;
+		ages.push_back(age);
+	}
+	Common::sort(ages.begin(), ages.end(), OlderEntry());
+
+	for (uint i = 0; i < ages.size() - kFilePropertiesCacheMaxEntries; ++i)
+		_entries.erase(ages[i].key);
+}
+
+void FilePropertiesCache::save() {
+	prune();
+
+	Common::ScopedPtr<Common::WriteStream> out(getCacheFile().createWriteStream());
+	if (!out)
+		return;
+
+	out->writeUint32BE(MKTAG('D', 'C', 'H', 'E'));
+	out->writeUint32LE(kFilePropertiesCacheVersion);
+	out->writeUint32LE(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		writeCacheString(out.get(), it->_key);
+		out->writeUint32LE(it->_value.modificationTime);
+		out->writeUint32LE(it->_value.age);
+		out->writeSint32LE(it->_value.fileProps.size);
+		writeCacheString(out.get(), it->_value.fileProps.md5);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("FilePropertiesCache::save: Could not write '%s'", kFilePropertiesCacheName);
+}
@@ -29,6 +29,11 @@
 #include "common/str-array.h"
 #include "common/language.h"
 #include "common/platform.h"
+#include "common/singleton.h"
+
+namespace Common {
+class FSNode;
+}
 
 /**
  * A simple structure used to map gameids (like "monkey", "sword1", ...) to
@@ -103,6 +108,71 @@ struct FileProperties {
  */
 typedef Common::HashMap<Common::String, FileProperties, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FilePropertiesMap;
 
+/**
+ * Cache for the properties of the files examined during detection.
+ *
+ * Most detectors compute the size and a partial MD5 of every candidate
+ * file, and many engines look at the same files. The cache makes sure this
+ * only happens once per file and scan. If the "detection_cache" option is
+ * enabled, the properties of files with a known modification time are also
+ * kept in a file in the cache directory, so that scanning the same
+ * directories again does not need to read any file. Entries for files which
+ * were removed or modified are dropped whenever that file is written, and
+ * the least recently used ones once there are too many.
+ *
+ * Scans are delimited by beginScan() and endScan(). They may be nested, so
+ * that a mass scan can wrap the individual EngineManager::detectGames calls.
+ */
+class FilePropertiesCache : public Common::Singleton<FilePropertiesCache> {
+public:
+	FilePropertiesCache();
+
+	void beginScan();
+	void endScan();
+
+	/**
+	 * Look up the properties of a file, given the number of bytes the MD5
+	 * was computed on. Returns false if the file is not in the cache, or if
+	 * it has been modified since its properties were stored.
+	 */
+	bool lookup(const Common::FSNode &node, uint32 md5Bytes, FileProperties &fileProps);
+	void store(const Common::FSNode &node, uint32 md5Bytes, const FileProperties &fileProps);
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+
+private:
+	struct Entry {
+		/** Modification time of the file, 0 if unknown */
+		uint32 modificationTime;
+		/** Number of times the cache was saved without this entry being used */
+		uint32 age;
+		/** Whether this entry was used since the cache was last saved */
+		bool used;
+		FileProperties fileProps;
+
+		Entry() : modificationTime(0), age(0), used(false) {}
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(const Common::FSNode &node, uint32 md5Bytes);
+
+	void load();
+	void prune();
+	void save();
+
+	EntryMap _entries;
+	uint _scanDepth;
+	bool _loaded;
+	bool _dirty;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+/** Shortcut for accessing the file properties cache. */
+#define FilePropsCache FilePropertiesCache::instance()
+
 /**
  * Details about a given game.
  *
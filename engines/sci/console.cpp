@@ -76,7 +76,8 @@ bool g_debug_track_mouse_clicks = false;
 static int parse_reg_t(EngineState *s, const char *str, reg_t *dest);
 
 Console::Console(SciEngine *engine) : GUI::Debugger(),
-	_engine(engine), _debugState(engine->_debugState) {
+	_engine(engine), _debugState(engine->_debugState),
+	_lastScriptStepCounter(0), _lastScriptStepTime(0) {
 
 	assert(_engine);
 	assert(_engine->_gamestate);
@@ -84,6 +85,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	registerVar("sleeptime_factor",	&g_debug_sleeptime_factor);
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
+	registerVar("gc_incremental",		&engine->_gamestate->gcIncremental);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
 	// FIXME: This actually passes an enum type instead of an integer but no
@@ -115,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -145,6 +148,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("visible_plane_list", WRAP_METHOD(Console, cmdVisiblePlaneList));
 	registerCmd("vpl",                WRAP_METHOD(Console, cmdVisiblePlaneList));	// alias
 	registerCmd("plane_items",        WRAP_METHOD(Console, cmdPlaneItemList));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	registerCmd("pi",                 WRAP_METHOD(Console, cmdPlaneItemList));	// alias
 	registerCmd("visible_plane_items", WRAP_METHOD(Console, cmdVisiblePlaneItemList));
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
@@ -163,6 +167,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -225,6 +230,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -308,6 +314,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("---------\n");
 	debugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	debugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	debugPrintf("gc_incremental: Whether garbage collections mark a slice at a time in between kernel calls\n");
 	debugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	debugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
 	debugPrintf("weak_validations: Turns some validation errors into warnings\n");
@@ -345,6 +352,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows or resets the resource cache usage and hit rates\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -373,6 +381,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" plane_list / pl - Shows a list of all the planes in the draw list (SCI2+)\n");
 	debugPrintf(" visible_plane_list / vpl - Shows a list of all the planes in the visible draw list (SCI2+)\n");
 	debugPrintf(" plane_items / pi - Shows a list of all items for a plane (SCI2+)\n");
+	debugPrintf(" cel_cache - Shows or resets the hit rate of the cel cache (SCI2+)\n");
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
@@ -388,6 +397,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows or resets the garbage collector pause times\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -432,7 +442,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" bp_function / bpe - Sets a breakpoint on the execution of the specified exported function\n");
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
-	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" script_steps - Shows the number of executed SCI operations, and the rate since the last call\n");
+	debugPrintf(" selector_cache - Shows or resets the hit rate of the selector lookup cache\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -1104,6 +1115,40 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		resMan->resetCacheStatistics();
+		debugPrintf("Resource cache statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the resource cache usage and the hit rate per resource type.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Locked: %d bytes\n", resMan->getLockedMemory());
+	debugPrintf("Unlocked: %d of %d bytes\n", resMan->getLRUMemory(ResourceManager::kLRUSegmentSmall) +
+		resMan->getLRUMemory(ResourceManager::kLRUSegmentLarge), resMan->getMaxLRUMemory());
+	debugPrintf("Small resources: %u entries, %d bytes, share %d bytes\n", resMan->getLRUEntries(ResourceManager::kLRUSegmentSmall),
+		resMan->getLRUMemory(ResourceManager::kLRUSegmentSmall), resMan->getLRUShare(ResourceManager::kLRUSegmentSmall));
+	debugPrintf("Large resources: %u entries, %d bytes, share %d bytes\n", resMan->getLRUEntries(ResourceManager::kLRUSegmentLarge),
+		resMan->getLRUMemory(ResourceManager::kLRUSegmentLarge), resMan->getLRUShare(ResourceManager::kLRUSegmentLarge));
+	debugPrintf("\n");
+	debugPrintf("Type          Hits    Misses  Hit rate  Evictions\n");
+	for (int i = 0; i < kResourceTypeInvalid; i++) {
+		const ResourceManager::CacheStatistics &stats = resMan->getCacheStatistics((ResourceType)i);
+		const uint32 lookups = stats.hits + stats.misses;
+		if (!lookups && !stats.evictions)
+			continue;
+		debugPrintf("%-12s %7u %7u %8.1f%% %9u\n", getResourceTypeName((ResourceType)i), stats.hits, stats.misses,
+			lookups ? stats.hits * 100.0 / lookups : 0.0, stats.evictions);
+	}
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2072,6 +2117,36 @@ bool Console::cmdPlaneList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		CelObj::resetCacheStats();
+		debugPrintf("Cel cache statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the hit rate of the cel cache.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 hits = CelObj::getCacheHits();
+	const uint32 misses = CelObj::getCacheMisses();
+	const uint32 lookups = hits + misses;
+	debugPrintf("Cached cels: %u of %u\n", CelObj::getCacheSize(), CelObj::getCacheCapacity());
+	debugPrintf("Lookups: %u\n", lookups);
+	debugPrintf("Hits: %u (%.1f%%), misses: %u\n", hits,
+		lookups ? hits * 100.0 / lookups : 0.0, misses);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdVisiblePlaneList(int argc, const char **argv) {
 #ifdef ENABLE_SCI32
 	if (_engine->_gfxFrameout) {
@@ -2838,6 +2913,36 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStatistics &stats = _engine->_gamestate->gcStats;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the pause times of the garbage collector.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Collections: %u, every %d kernel calls, %s\n", stats.runs, _engine->_gamestate->scriptGCInterval,
+		_engine->_gamestate->gcIncremental ? "incremental" : "all at once");
+	if (stats.runs) {
+		debugPrintf("Pause time: last %u ms, average %.2f ms, max %u ms\n", stats.lastTime,
+			(double)stats.totalTime / stats.runs, stats.maxTime);
+		debugPrintf("Last collection: %u reachable, %u freed\n", stats.lastReachable, stats.lastFreed);
+		debugPrintf("Total freed: %u\n", stats.totalFreed);
+	}
+	if (stats.markSteps)
+		debugPrintf("Marking steps: %u, max %u ms, %u collections marked again\n", stats.markSteps,
+			stats.maxMarkStepTime, stats.remarks);
+	if (stats.minorRuns)
+		debugPrintf("Nursery collections: %u, average %.2f ms, max %u ms, %u arrays freed\n", stats.minorRuns,
+			(double)stats.minorTotalTime / stats.minorRuns, stats.minorMaxTime, stats.minorFreed);
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -2947,6 +3052,7 @@ bool Console::cmdVMVars(int argc, const char **argv) {
 			debugPrintf("Or pass a decimal or hexadecimal value directly (e.g. 12, 1Ah)\n");
 			return true;
 		}
+		s->_segMan->writeBarrier(*curValue);
 	}
 	return true;
 }
@@ -3263,7 +3369,39 @@ bool Console::cmdViewAccumulatorObject(int argc, const char **argv) {
 }
 
 bool Console::cmdScriptSteps(int argc, const char **argv) {
-	debugPrintf("Number of executed SCI operations: %d\n", _engine->_gamestate->scriptStepCounter);
+	const int steps = _engine->_gamestate->scriptStepCounter;
+	const uint32 time = g_system->getMillis();
+	debugPrintf("Number of executed SCI operations: %d\n", steps);
+
+	// Report the throughput since the previous invocation
+	if (_lastScriptStepTime && time > _lastScriptStepTime && steps >= _lastScriptStepCounter) {
+		debugPrintf("%d operations in the last %.1f seconds, %.0f operations per second\n",
+			steps - _lastScriptStepCounter, (time - _lastScriptStepTime) / 1000.0,
+			(steps - _lastScriptStepCounter) * 1000.0 / (time - _lastScriptStepTime));
+	}
+	_lastScriptStepCounter = steps;
+	_lastScriptStepTime = time;
+	return true;
+}
+
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		cache.resetStats();
+		debugPrintf("Selector lookup cache statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the hit rate of the selector lookup cache.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("Selector lookups: %u\n", lookups);
+	debugPrintf("Hits: %u (%.1f%%), misses: %u\n", cache.getHits(),
+		lookups ? cache.getHits() * 100.0 / lookups : 0.0, cache.getMisses());
+	debugPrintf("Invalidations: %u\n", cache.getInvalidations());
 	return true;
 }
 
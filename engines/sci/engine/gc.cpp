@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -56,10 +57,12 @@ void WorklistManager::push(reg_t reg) {
 
 	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
 
-	if (_map.contains(reg))
+	// Look up and insert with a single hash lookup
+	bool &seen = _map[reg];
+	if (seen)
 		return; // already dealt with it
 
-	_map.setVal(reg, true);
+	seen = true;
 	_worklist.push_back(reg);
 }
 
@@ -84,26 +87,34 @@ static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_
 	return normal_map;
 }
 
-static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
+/**
+ * Finds the outgoing references of at most maxCount addresses of the worklist
+ * @return true if the worklist has been emptied
+ */
+static bool processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap, uint maxCount = 0xFFFFFFFF) {
 	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
-	while (!wm._worklist.empty()) {
+	while (!wm._worklist.empty() && maxCount--) {
 		reg_t reg = wm._worklist.back();
 		wm._worklist.pop_back();
 		if (reg.getSegment() != stackSegment) { // No need to repeat this one
 			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
-			if (reg.getSegment() < heap.size() && heap[reg.getSegment()]) {
+			// The write barrier may have recorded references which have been
+			// freed in the meantime, so skip everything which is gone
+			if (reg.getSegment() < heap.size() && heap[reg.getSegment()] && heap[reg.getSegment()]->isValidOffset(reg.getOffset())) {
 				// Valid heap object? Find its outgoing references!
 				wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
 			}
 		}
 	}
+	return wm._worklist.empty();
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+/**
+ * Adds the registers, the value stack and the execution stack to the worklist
+ */
+static void pushStackRoots(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -139,6 +150,13 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished adding execution stack");
+}
+
+/**
+ * Adds the whole root set to the worklist
+ */
+static void pushRoots(EngineState *s, WorklistManager &wm) {
+	pushStackRoots(s, wm);
 
 	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	uint heapSize = heap.size();
@@ -170,7 +188,40 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
+
+/**
+ * Adds what the write barrier recorded to the worklist. Written entries are
+ * scanned right away, as they may be reachable already.
+ */
+static void pushWriteLog(const Common::Array<SegmentObj *> &heap, WorklistManager &wm, const GCWriteLog &log) {
+	wm.pushArray(log.storedRefs);
+
+	for (uint i = 0; i < log.writtenEntries.size(); ++i) {
+		const reg_t addr = log.writtenEntries[i];
+		SegmentObj *mobj = addr.getSegment() < heap.size() ? heap[addr.getSegment()] : nullptr;
+		if (mobj && mobj->isValidOffset(addr.getOffset()))
+			wm.pushArray(mobj->listAllOutgoingReferences(addr));
+	}
+}
 
+/**
+ * Adds the contents of the global variables to the worklist. The engine
+ * writes to some of them directly, without going through the write barrier.
+ */
+static void pushGlobals(EngineState *s, WorklistManager &wm) {
+	const SegmentId globalsSegment = s->variablesSegment[VAR_GLOBAL];
+	SegmentObj *mobj = s->_segMan->getSegmentObj(globalsSegment);
+	if (mobj)
+		wm.pushArray(mobj->listAllOutgoingReferences(make_reg(globalsSegment, 0)));
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRoots(s, wm);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	processWorkList(s->_segMan, wm, heap);
 
 	if (g_sci->_gfxPorts)
@@ -179,11 +230,22 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
+static bool hasNursery() {
+#ifdef ENABLE_SCI32
+	return getSciVersion() >= SCI_VERSION_2;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Frees everything which is not in activeRefs, and records the statistics
+ * of the collection which started at startTime
+ */
+static void sweep(EngineState *s, AddrSet *activeRefs, uint32 startTime) {
 	SegManager *segMan = s->_segMan;
+	uint32 freed = 0;
 
-	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
@@ -191,9 +253,6 @@ void run_gc(EngineState *s) {
 	memset(segcount, 0, sizeof(segcount));
 #endif
 
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
-
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
 	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
@@ -214,6 +273,7 @@ void run_gc(EngineState *s) {
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					++freed;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -224,8 +284,20 @@ void run_gc(EngineState *s) {
 		}
 	}
 
+	// Whatever survived is old now
+	segMan->getGCWriteLog().clear();
+
+	GCStatistics &stats = s->gcStats;
+	stats.lastReachable = activeRefs->size();
 	delete activeRefs;
 
+	stats.lastTime = g_system->getMillis(true) - startTime;
+	stats.totalTime += stats.lastTime;
+	stats.maxTime = MAX(stats.maxTime, stats.lastTime);
+	stats.lastFreed = freed;
+	stats.totalFreed += freed;
+	++stats.runs;
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -235,4 +307,176 @@ void run_gc(EngineState *s) {
 #endif
 }
 
+void run_gc(EngineState *s) {
+	const uint32 startTime = g_system->getMillis(true);
+
+	// Some debug stuff
+	debugC(kDebugLevelGC, "[GC] Running...");
+
+	abort_gc(s);
+
+	// Compute the set of all segments references currently in use.
+	sweep(s, findAllActiveReferences(s), startTime);
+}
+
+void abort_gc(EngineState *s) {
+	if (s->_incrementalGC) {
+		// The slices consumed some of the stored references, so the nursery
+		// can't tell anymore which arrays are garbage
+		s->_segMan->getGCWriteLog().newArrays.clear();
+		delete s->_incrementalGC;
+		s->_incrementalGC = nullptr;
+	}
+
+	s->_segMan->setWriteBarrier(hasNursery());
+	if (!hasNursery())
+		s->_segMan->getGCWriteLog().clear();
+}
+
+static void startIncrementalGC(EngineState *s) {
+	debugC(kDebugLevelGC, "[GC] Starting to mark...");
+
+	IncrementalGC *gc = new IncrementalGC();
+	gc->reusedSegments = s->_segMan->getGCWriteLog().reusedSegments;
+	pushRoots(s, gc->wm);
+
+	s->_incrementalGC = gc;
+	s->_segMan->setWriteBarrier(true);
+}
+
+/**
+ * Marks what the scripts changed since marking started, and frees what is
+ * unreachable
+ */
+static void finishIncrementalGC(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	GCWriteLog &log = segMan->getGCWriteLog();
+	IncrementalGC *gc = s->_incrementalGC;
+
+	if (log.reusedSegments != gc->reusedSegments) {
+		// Addresses marked earlier may refer to something else by now
+		debugC(kDebugLevelGC, "[GC] Segments got reused, marking everything again");
+		++s->gcStats.remarks;
+		run_gc(s);
+		return;
+	}
+
+	const uint32 startTime = g_system->getMillis(true);
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	WorklistManager &wm = gc->wm;
+
+	// Whatever the roots refer to now, and whatever got stored elsewhere
+	pushRoots(s, wm);
+	pushGlobals(s, wm);
+	pushWriteLog(heap, wm, log);
+	processWorkList(segMan, wm, heap);
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(wm);
+
+	AddrSet *activeRefs = normalizeAddresses(segMan, wm._map);
+	abort_gc(s);
+	sweep(s, activeRefs, startTime);
+}
+
+static void markIncrementalGC(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	GCWriteLog &log = segMan->getGCWriteLog();
+	WorklistManager &wm = s->_incrementalGC->wm;
+	const uint32 startTime = g_system->getMillis(true);
+
+	// Stored references can be marked right away. Written entries have to
+	// wait for the end, as they may still be written to.
+	wm.pushArray(log.storedRefs);
+	log.storedRefs.clear();
+
+	const bool done = processWorkList(segMan, wm, segMan->getSegments(), GC_MARK_SLICE);
+
+	GCStatistics &stats = s->gcStats;
+	++stats.markSteps;
+	stats.maxMarkStepTime = MAX<uint32>(stats.maxMarkStepTime, g_system->getMillis(true) - startTime);
+
+	if (done)
+		finishIncrementalGC(s);
+}
+
+#ifdef ENABLE_SCI32
+/**
+ * Frees the arrays allocated since the last collection which are not
+ * referenced from the stack, the registers, the global variables or anything
+ * the write barrier has seen being written to
+ */
+static void collectNursery(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	GCWriteLog &log = segMan->getGCWriteLog();
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	const uint32 startTime = g_system->getMillis(true);
+	uint32 freed = 0;
+
+	AddrSet young;
+	for (uint i = 0; i < log.newArrays.size(); ++i) {
+		const reg_t addr = log.newArrays[i];
+		SegmentObj *mobj = addr.getSegment() < heap.size() ? heap[addr.getSegment()] : nullptr;
+		if (mobj && mobj->getType() == SEG_TYPE_ARRAY && mobj->isValidOffset(addr.getOffset()))
+			young.setVal(addr, true);
+	}
+
+	if (!young.empty()) {
+		WorklistManager wm;
+		pushStackRoots(s, wm);
+		pushGlobals(s, wm);
+		pushWriteLog(heap, wm, log);
+
+		// Everything old is kept anyway, so only young arrays need scanning
+		while (!wm._worklist.empty()) {
+			const reg_t reg = wm._worklist.back();
+			wm._worklist.pop_back();
+			if (young.contains(reg))
+				wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
+		}
+
+		for (AddrSet::const_iterator i = young.begin(); i != young.end(); ++i) {
+			if (!wm._map.contains(i->_key)) {
+				heap[i->_key.getSegment()]->freeAtAddress(segMan, i->_key);
+				++freed;
+				debugC(kDebugLevelGC, "[GC] Deallocating young %04x:%04x", PRINT_REG(i->_key));
+			}
+		}
+	}
+
+	log.clear();
+
+	GCStatistics &stats = s->gcStats;
+	const uint32 time = g_system->getMillis(true) - startTime;
+	++stats.minorRuns;
+	stats.minorTotalTime += time;
+	stats.minorMaxTime = MAX(stats.minorMaxTime, time);
+	stats.minorFreed += freed;
+}
+#endif
+
+void run_gc_step(EngineState *s) {
+	if (s->gcCountDown-- <= 0) {
+		s->gcCountDown = s->scriptGCInterval;
+		if (!s->gcIncremental)
+			run_gc(s);
+		else if (!s->_incrementalGC)
+			startIncrementalGC(s);
+	}
+
+	if (s->_incrementalGC) {
+		markIncrementalGC(s);
+		return;
+	}
+
+#ifdef ENABLE_SCI32
+	// Inside of a kernel call, the kernel function may be working on arrays
+	// nothing refers to yet
+	if (hasNursery() && --s->gcNurseryCountDown <= 0 && !s->executionStackBase) {
+		s->gcNurseryCountDown = GC_NURSERY_INTERVAL;
+		collectNursery(s);
+	}
+#endif
+}
+
 } // End of namespace Sci
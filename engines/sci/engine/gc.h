@@ -50,11 +50,31 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs garbage collection on the current system state, all at once. An
+ * incremental collection in progress is dropped.
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
 
+/**
+ * Does the garbage collection work due at a kernel call. Every
+ * scriptGCInterval kernel calls a collection starts. Unless gcIncremental
+ * is off, it marks GC_MARK_SLICE addresses per kernel call, and the pause
+ * at the end only covers what the scripts changed meanwhile, which the
+ * write barrier of the SegManager records. In between collections, SCI32
+ * arrays which are not referenced from anywhere the write barrier has seen
+ * are freed every GC_NURSERY_INTERVAL kernel calls, as most of them are
+ * temporary strings.
+ * @param s The state in which we should gc
+ */
+void run_gc_step(EngineState *s);
+
+/**
+ * Drops the incremental collection in progress, if any
+ * @param s The state in which we should gc
+ */
+void abort_gc(EngineState *s);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
@@ -63,6 +83,14 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * An incremental collection in progress
+ */
+struct IncrementalGC {
+	WorklistManager wm;
+	uint32 reusedSegments; /**< GCWriteLog::reusedSegments when marking started */
+};
+
 
 } // End of namespace Sci
 
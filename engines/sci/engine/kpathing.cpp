@@ -69,6 +69,12 @@ enum {
 
 #define VERTEX_HAS_EDGES(V) ((V) != CLIST_NEXT(V))
 
+// Size of the cells of the grid used to find edges near a line segment
+#define EDGE_GRID_CELL_SHIFT 5
+
+// Below this number of edges all of them are simply tested
+#define EDGE_GRID_MIN_EDGES 16
+
 // Error codes
 enum {
 	PF_OK = 0,
@@ -117,10 +123,15 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Index of the vertex in the polygon set before the start and end points
+	// were merged into it, or -1 if it was added by merging
+	int staticIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		staticIndex = -1;
 	}
 };
 
@@ -263,6 +274,26 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Set when merging the start or end point split a polygon edge
+	bool _edgeSplit;
+
+	// Cached visibility between the vertices of the polygon set, indexed by
+	// their staticIndex. NULL if it can't be used.
+	Common::Array<byte> *_visibility;
+	uint _staticVertices;
+
+	// Uniform grid over the polygon edges. Each cell lists the vertex_index
+	// entries of the edges whose bounding box overlaps it, from
+	// _gridEdges[_gridCellStart[cell]] up to _gridEdges[_gridCellStart[cell + 1]].
+	// Empty if there are too few edges for the grid to pay off.
+	int _gridLeft, _gridTop, _gridColumns, _gridRows;
+	Common::Array<uint> _gridCellStart;
+	Common::Array<uint> _gridEdges;
+
+	// Per vertex_index entry, the last query which tested its edge
+	Common::Array<uint32> _edgeQuery;
+	uint32 _query;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -270,6 +301,11 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_edgeSplit = false;
+		_visibility = NULL;
+		_staticVertices = 0;
+		_gridLeft = _gridTop = _gridColumns = _gridRows = 0;
+		_query = 0;
 	}
 
 	~PathfindingState() {
@@ -286,6 +322,7 @@ struct PathfindingState {
 	bool pointOnScreenBorder(const Common::Point &p);
 	bool edgeOnScreenBorder(const Common::Point &p, const Common::Point &q);
 	int findNearPoint(const Common::Point &p, Polygon *polygon, Common::Point *ret);
+	void buildEdgeGrid();
 };
 
 static Common::Point readPoint(SegmentRef list_r, int offset) {
@@ -699,6 +736,143 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Builds the grid of polygon edges used by segment_blocked()
+ */
+void PathfindingState::buildEdgeGrid() {
+	int edges = 0;
+	int left = 0, top = 0, right = 0, bottom = 0;
+
+	for (int i = 0; i < vertices; i++) {
+		Vertex *edge = vertex_index[i];
+		if (!VERTEX_HAS_EDGES(edge))
+			continue;
+
+		const Common::Point &p = edge->v;
+		if (!edges) {
+			left = right = p.x;
+			top = bottom = p.y;
+		} else {
+			left = MIN<int>(left, p.x);
+			right = MAX<int>(right, p.x);
+			top = MIN<int>(top, p.y);
+			bottom = MAX<int>(bottom, p.y);
+		}
+		++edges;
+	}
+
+	if (edges < EDGE_GRID_MIN_EDGES)
+		return;
+
+	_gridLeft = left;
+	_gridTop = top;
+	_gridColumns = ((right - left) >> EDGE_GRID_CELL_SHIFT) + 1;
+	_gridRows = ((bottom - top) >> EDGE_GRID_CELL_SHIFT) + 1;
+
+	// Count the edges per cell first, then fill in the edges
+	Common::Array<uint> cellFill;
+	cellFill.resize(_gridColumns * _gridRows);
+
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < vertices; i++) {
+			Vertex *edge = vertex_index[i];
+			if (!VERTEX_HAS_EDGES(edge))
+				continue;
+
+			const Common::Point &p = edge->v;
+			const Common::Point &q = CLIST_NEXT(edge)->v;
+			const int x1 = (MIN(p.x, q.x) - _gridLeft) >> EDGE_GRID_CELL_SHIFT;
+			const int x2 = (MAX(p.x, q.x) - _gridLeft) >> EDGE_GRID_CELL_SHIFT;
+			const int y1 = (MIN(p.y, q.y) - _gridTop) >> EDGE_GRID_CELL_SHIFT;
+			const int y2 = (MAX(p.y, q.y) - _gridTop) >> EDGE_GRID_CELL_SHIFT;
+
+			for (int y = y1; y <= y2; y++) {
+				for (int x = x1; x <= x2; x++) {
+					const int cell = y * _gridColumns + x;
+					if (pass == 1)
+						_gridEdges[_gridCellStart[cell] + cellFill[cell]] = i;
+					cellFill[cell]++;
+				}
+			}
+		}
+
+		if (pass == 0) {
+			_gridCellStart.resize(_gridColumns * _gridRows + 1);
+			_gridCellStart[0] = 0;
+			for (uint cell = 0; cell < cellFill.size(); cell++) {
+				_gridCellStart[cell + 1] = _gridCellStart[cell] + cellFill[cell];
+				cellFill[cell] = 0;
+			}
+			_gridEdges.resize(_gridCellStart.back());
+		}
+	}
+
+	_edgeQuery.resize(vertices);
+}
+
+/**
+ * Determines whether or not an edge blocks the direct line between two
+ * vertices
+ * Parameters: (const Vertex *) from, to: The line
+ *             (Vertex *) edge: The first vertex of the edge
+ * Returns   : (bool) true if the edge blocks the line
+ */
+static bool edge_blocks(const Vertex *from, const Vertex *to, Vertex *edge) {
+	if (between(from->v, to->v, edge->v)) {
+		// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+		return inside(from->v, edge) || inside(to->v, edge);
+	}
+
+	return intersect_proper(from->v, to->v, edge->v, CLIST_NEXT(edge)->v);
+}
+
+/**
+ * Determines whether or not any polygon edge blocks the direct line between
+ * two vertices. Only the edges in the grid cells overlapping the line's
+ * bounding box are tested, as no other edge can touch the line.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (const Vertex *) from, to: The line
+ * Returns   : (bool) true if the line is blocked
+ */
+static bool segment_blocked(PathfindingState *s, const Vertex *from, const Vertex *to) {
+	if (s->_gridEdges.empty()) {
+		for (int j = 0; j < s->vertices; j++) {
+			Vertex *edge = s->vertex_index[j];
+			if (VERTEX_HAS_EDGES(edge) && edge_blocks(from, to, edge))
+				return true;
+		}
+		return false;
+	}
+
+	const int x1 = MAX<int>((MIN(from->v.x, to->v.x) - s->_gridLeft) >> EDGE_GRID_CELL_SHIFT, 0);
+	const int x2 = MIN<int>((MAX(from->v.x, to->v.x) - s->_gridLeft) >> EDGE_GRID_CELL_SHIFT, s->_gridColumns - 1);
+	const int y1 = MAX<int>((MIN(from->v.y, to->v.y) - s->_gridTop) >> EDGE_GRID_CELL_SHIFT, 0);
+	const int y2 = MIN<int>((MAX(from->v.y, to->v.y) - s->_gridTop) >> EDGE_GRID_CELL_SHIFT, s->_gridRows - 1);
+
+	// Edges spanning several cells are only tested once per query
+	if (++s->_query == 0) {
+		Common::fill(s->_edgeQuery.begin(), s->_edgeQuery.end(), 0);
+		s->_query = 1;
+	}
+
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) {
+			const int cell = y * s->_gridColumns + x;
+			for (uint k = s->_gridCellStart[cell]; k < s->_gridCellStart[cell + 1]; k++) {
+				const uint j = s->_gridEdges[k];
+				if (s->_edgeQuery[j] == s->_query)
+					continue;
+				s->_edgeQuery[j] = s->_query;
+
+				if (edge_blocks(from, to, s->vertex_index[j]))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -715,26 +889,25 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
 			continue;
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
+		// Check for intersecting edges. Whether the line between two
+		// vertices of the polygon set is blocked doesn't depend on the
+		// start and end points, so it is remembered across calls.
+		bool blocked;
+		if (s->_visibility && vertex_cur->staticIndex >= 0 && vertex->staticIndex >= 0) {
+			const uint n = s->_staticVertices;
+			byte &state = (*s->_visibility)[vertex_cur->staticIndex * n + vertex->staticIndex];
+			if (state == VisibilityCache::kUnknown) {
+				blocked = segment_blocked(s, vertex_cur, vertex);
+				state = blocked ? VisibilityCache::kBlocked : VisibilityCache::kVisible;
+				(*s->_visibility)[vertex->staticIndex * n + vertex_cur->staticIndex] = state;
+			} else {
+				blocked = (state == VisibilityCache::kBlocked);
 			}
+		} else {
+			blocked = segment_blocked(s, vertex_cur, vertex);
 		}
 
-		if (j == s->vertices)
+		if (!blocked)
 			visVerts->push_front(vertex);
 	}
 
@@ -1129,6 +1302,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 				if (between(vertex->v, next->v, v)) {
 					// Split edge by adding vertex
 					polygon->vertices.insertAfter(vertex, v_new);
+					s->_edgeSplit = true;
 					return v_new;
 				}
 			}
@@ -1322,10 +1496,33 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// Number the vertices of the polygon set before the start and end points
+	// are merged into it, and record its geometry for the visibility cache
+	Common::Array<int16> geometry;
+	int staticIndex = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		polygon = *it;
+		Vertex *vertex;
+
+		geometry.push_back(polygon->vertices.size());
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->staticIndex = staticIndex++;
+			geometry.push_back(vertex->v.x);
+			geometry.push_back(vertex->v.y);
+		}
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
 
+	// Splitting an edge changes the visibility between the other vertices
+	if (!pf_s->_edgeSplit && staticIndex <= VisibilityCache::kMaxVertices) {
+		pf_s->_staticVertices = staticIndex;
+		pf_s->_visibility = &s->_visibilityCache.getVisibility(geometry, staticIndex);
+	}
+
 	delete new_start;
 	delete new_end;
 
@@ -1344,6 +1541,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	}
 
 	pf_s->vertices = count;
+	pf_s->buildEdgeGrid();
 
 	return pf_s;
 }
@@ -73,6 +73,8 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_decodedInstructions.clear();
 }
 
 enum {
@@ -705,6 +707,52 @@ bool Script::relocateLocal(SegmentId segment, int location, uint32 offset) {
 		return false;
 }
 
+int Script::decodeInstructionUncached(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+	const int size = readPMachineInstruction(getBuf(offset), extOpcode, opparams);
+
+	// Instructions which don't fit in the table (debug file names, or
+	// too many instructions) are simply decoded each time
+	if (size > 0xFFFF)
+		return size;
+
+	DecodedInstruction instruction;
+	memcpy(instruction.opparams, opparams, sizeof(instruction.opparams));
+	instruction.size = size;
+	instruction.extOpcode = extOpcode;
+	_decodedInstructions.add(offset, getBufSize(), instruction);
+
+	return size;
+}
+
+void DecodedInstructionTable::clear() {
+	_starts.clear();
+	_ranks.clear();
+	_instructions.clear();
+}
+
+bool DecodedInstructionTable::add(uint32 offset, uint32 bufSize, const DecodedInstruction &instruction) {
+	if (_instructions.size() >= kMaxInstructions)
+		return false;
+
+	if (_starts.empty()) {
+		_starts.resize((bufSize + 31) >> 5);
+		_ranks.resize(_starts.size());
+	}
+
+	const uint32 word = offset >> 5;
+	const uint32 mask = 1u << (offset & 31);
+	assert(word < _starts.size() && !(_starts[word] & mask));
+
+	// Instructions are decoded in the order they run, so this usually
+	// inserts in the middle. That only happens once per instruction though.
+	_instructions.insert_at(_ranks[word] + countBits(_starts[word] & (mask - 1)), instruction);
+	_starts[word] |= mask;
+	for (uint32 i = word + 1; i < _ranks.size(); ++i)
+		++_ranks[i];
+
+	return true;
+}
+
 uint32 Script::getRelocationOffset(const uint32 offset) const {
 	if (getSciVersion() == SCI_VERSION_3) {
 		SciSpan<const byte> relocStart = _buf->subspan(_buf->getUint32SEAt(8));
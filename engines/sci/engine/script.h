@@ -69,6 +69,62 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/** A VM instruction with its operands, as decoded by readPMachineInstruction() */
+struct DecodedInstruction {
+	int16 opparams[4];
+	uint16 size;
+	byte extOpcode;
+};
+
+/**
+ * The instructions of a script which have been decoded so far, sorted by
+ * offset. A bitmap marks the offsets at which they start, and the number of
+ * instructions in front of each word of the bitmap leads from an offset to
+ * its instruction, so the index takes 1.5 bits per byte of the script.
+ */
+class DecodedInstructionTable {
+public:
+	enum {
+		kMaxInstructions = 0xFFFF
+	};
+
+	void clear();
+
+	/** Returns the instruction decoded at the given offset, or NULL if none was. */
+	const DecodedInstruction *find(uint32 offset) const {
+		const uint32 word = offset >> 5;
+		if (word >= _starts.size())
+			return NULL;
+
+		const uint32 bits = _starts[word];
+		const uint32 mask = 1u << (offset & 31);
+		if (!(bits & mask))
+			return NULL;
+
+		return &_instructions[_ranks[word] + countBits(bits & (mask - 1))];
+	}
+
+	/**
+	 * Adds the instruction decoded at the given offset of a buffer of the
+	 * given size, which has to be the same for all instructions.
+	 * @return false if the table is full
+	 */
+	bool add(uint32 offset, uint32 bufSize, const DecodedInstruction &instruction);
+
+	uint size() const { return _instructions.size(); }
+
+private:
+	static uint countBits(uint32 bits) {
+		bits = bits - ((bits >> 1) & 0x55555555);
+		bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+		return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+	}
+
+	Common::Array<uint32> _starts; /**< One bit per offset, set where a decoded instruction starts */
+	Common::Array<uint16> _ranks; /**< Number of decoded instructions in front of each word of _starts */
+	Common::Array<DecodedInstruction> _instructions;
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -102,6 +158,8 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	DecodedInstructionTable _decodedInstructions;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -118,6 +176,24 @@ public:
 	}
 
 	const byte *getBuf(uint offset = 0) const { return _buf->getUnsafeDataAt(offset); }
+
+	/**
+	 * Decodes the VM instruction at the given offset, like
+	 * readPMachineInstruction(). Each instruction is only decoded the first
+	 * time it is executed, since the code doesn't change anymore once the
+	 * script has been loaded and patched.
+	 * @return the size of the instruction in bytes
+	 */
+	int decodeInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+		const DecodedInstruction *instruction = _decodedInstructions.find(offset);
+		if (instruction) {
+			extOpcode = instruction->extOpcode;
+			memcpy(opparams, instruction->opparams, sizeof(instruction->opparams));
+			return instruction->size;
+		}
+
+		return decodeInstructionUncached(offset, extOpcode, opparams);
+	}
 	SciSpan<const byte> getSpan(uint offset) const { return _buf->subspan(offset); }
 
 	int getScriptNumber() const { return _nr; }
@@ -295,6 +371,8 @@ public:
 	uint32 getRelocationOffset(const uint32 offset) const;
 
 private:
+	int decodeInstructionUncached(uint32 offset, byte &extOpcode, int16 opparams[4]);
+
 	/**
 	 * Returns a Span containing the relocation table for a SCI0-SCI2.1 script.
 	 * (The SCI0-SCI2.1 relocation table is simply a list of all of the
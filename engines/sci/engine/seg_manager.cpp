@@ -43,6 +43,8 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_saveDirPtr = NULL_REG;
 	_parserPtr = NULL_REG;
 
+	_gcWriteBarrier = false;
+
 #ifdef ENABLE_SCI32
 	_arraysSegId = 0;
 	_bitmapSegId = 0;
@@ -80,6 +82,12 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	_selectorLookupCache.invalidate();
+
+	// Everything the garbage collector may have marked is gone
+	_gcWriteLog.clear();
+	++_gcWriteLog.reusedSegments;
 }
 
 void SegManager::initSysStrings() {
@@ -123,6 +131,10 @@ SegmentObj *SegManager::allocSegment(SegmentObj *mem, SegmentId *segid) {
 	if (id >= (int)_heap.size()) {
 		assert(id == (int)_heap.size());
 		_heap.push_back(0);
+	} else {
+		// Addresses the garbage collector marked in the segment which used
+		// this ID before now refer to something else
+		++_gcWriteLog.reusedSegments;
 	}
 	_heap[id] = mem;
 
@@ -182,6 +194,9 @@ void SegManager::deallocate(SegmentId seg) {
 
 	delete mobj;
 	_heap[actualSegment] = NULL;
+
+	// Objects may have lived in the segment
+	_selectorLookupCache.invalidate();
 }
 
 bool SegManager::isHeapObject(reg_t pos) const {
@@ -440,6 +455,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	markWritten(*addr);
 	return &table->at(offset);
 }
 
@@ -454,6 +470,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	markWritten(*addr);
 	return &table->at(offset);
 }
 
@@ -468,6 +485,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	markWritten(*addr);
 	return &table->at(offset);
 }
 
@@ -494,6 +512,7 @@ List *SegManager::lookupList(reg_t addr) {
 		return NULL;
 	}
 
+	markWritten(addr);
 	return &(lt[addr.getOffset()]);
 }
 
@@ -518,6 +537,7 @@ Node *SegManager::lookupNode(reg_t addr, bool stopOnDiscarded) {
 		return NULL;
 	}
 
+	markWritten(addr);
 	return &(nt[addr.getOffset()]);
 }
 
@@ -531,6 +551,14 @@ SegmentRef SegManager::dereference(reg_t pointer) {
 	}
 
 	SegmentObj *mobj = _heap[pointer.getSegment()];
+	// Kernel functions write references to variables through the pointers
+	// returned here
+	if (mobj->getType() == SEG_TYPE_LOCALS)
+		markWritten(pointer);
+#ifdef ENABLE_SCI32
+	else if (mobj->getType() == SEG_TYPE_ARRAY)
+		markWritten(pointer);
+#endif
 	return mobj->dereference(pointer);
 }
 
@@ -895,6 +923,9 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	markWritten(*addr);
+	if (_gcWriteBarrier)
+		_gcWriteLog.newArrays.push_back(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -911,6 +942,7 @@ SciArray *SegManager::lookupArray(reg_t addr) {
 	if (!arrayTable.isValidEntry(addr.getOffset()))
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	markWritten(addr);
 	return &(arrayTable[addr.getOffset()]);
 }
 
@@ -1037,6 +1069,9 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 			return segmentId;
 		} else {
 			scr->freeScript(true);
+			// The objects of the new script replace the old ones at the
+			// same addresses
+			++_gcWriteLog.reusedSegments;
 		}
 	} else {
 		scr = allocateScript(scriptNum, &segmentId);
@@ -1046,6 +1081,7 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
 	scr->initializeObjects(this, segmentId, applyScriptPatches);
+	_selectorLookupCache.invalidate();
 #ifdef ENABLE_SCI32
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
+#include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/segment.h"
@@ -46,6 +47,26 @@ enum ScriptLoadType {
 
 class Script;
 
+/**
+ * The heap changes recorded by the write barrier of the SegManager, for the
+ * garbage collector. See gc.h.
+ */
+struct GCWriteLog {
+	Common::Array<reg_t> storedRefs; /**< References stored into object properties and variables */
+	Common::Array<reg_t> writtenEntries; /**< Clones, lists, nodes, arrays and locals handed out for writing */
+	Common::Array<reg_t> newArrays; /**< Arrays allocated since the log was cleared, i.e. the nursery */
+	uint32 reusedSegments; /**< Counts how often a segment ID or script segment got reused */
+
+	GCWriteLog() : reusedSegments(0) {}
+
+	/** Forgets the recorded changes, except for the segment reuse counter */
+	void clear() {
+		storedRefs.clear();
+		writtenEntries.clear();
+		newArrays.clear();
+	}
+};
+
 class SegManager : public Common::Serializable {
 	friend class Console;
 public:
@@ -458,6 +479,35 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Returns the cache used by lookupSelector()
+	 */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
+	/**
+	 * Write barrier of the garbage collector. Must be called with every
+	 * reference which is stored into an object property or a global or local
+	 * variable, since these are written to through plain pointers. Writes to
+	 * clones, lists, nodes and arrays are recorded by the functions handing
+	 * them out instead.
+	 */
+	void writeBarrier(reg_t value) {
+		if (_gcWriteBarrier && value.getSegment() && (_gcWriteLog.storedRefs.empty() || _gcWriteLog.storedRefs.back() != value))
+			_gcWriteLog.storedRefs.push_back(value);
+	}
+
+	/**
+	 * Enables or disables the write barrier. The garbage collector needs it
+	 * while it marks incrementally and to collect the nursery.
+	 */
+	void setWriteBarrier(bool enable) { _gcWriteBarrier = enable; }
+	bool hasWriteBarrier() const { return _gcWriteBarrier; }
+
+	/**
+	 * Returns what the write barrier recorded
+	 */
+	GCWriteLog &getGCWriteLog() { return _gcWriteLog; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -476,6 +526,20 @@ private:
 	reg_t _saveDirPtr;
 	reg_t _parserPtr;
 
+	SelectorLookupCache _selectorLookupCache;
+
+	bool _gcWriteBarrier;
+	GCWriteLog _gcWriteLog;
+
+	/**
+	 * Records that the entry at addr may be written to, so that the garbage
+	 * collector scans it again.
+	 */
+	void markWritten(reg_t addr) {
+		if (_gcWriteBarrier && (_gcWriteLog.writtenEntries.empty() || _gcWriteLog.writtenEntries.back() != addr))
+			_gcWriteLog.writtenEntries.push_back(addr);
+	}
+
 #ifdef ENABLE_SCI32
 	SegmentId _arraysSegId;
 	SegmentId _bitmapSegId;
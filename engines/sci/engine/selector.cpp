@@ -285,6 +285,7 @@ void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t
 	}
 
 	*address.getPointer(segMan) = value;
+	segMan->writeBarrier(value);
 #ifdef ENABLE_SCI32
 	updateInfoFlagViewVisible(segMan->getObject(object), address.varindex);
 #endif
@@ -325,15 +326,22 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
-SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+SelectorLookupCache::SelectorLookupCache() : _generation(1), _hits(0), _misses(0), _invalidations(0) {
+	reset();
+}
+
+void SelectorLookupCache::reset() {
+	for (uint i = 0; i < kCacheSize; ++i)
+		_entries[i].generation = 0;
+	_generation = 1;
+}
+
+static SelectorType lookupSelectorUncached(SegManager *segMan, reg_t obj_location, Selector selectorId, uint16 &varIndex, reg_t &func) {
 	const Object *obj = segMan->getObject(obj_location);
 	int index;
-	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
 
-	// Early SCI versions used the LSB in the selector ID as a read/write
-	// toggle, meaning that we must remove it for selector lookup.
-	if (oldScriptHeader)
-		selectorId &= ~1;
+	varIndex = 0;
+	func = NULL_REG;
 
 	if (!obj) {
 		const SciCallOrigin origin = g_sci->getEngineState()->getCurrentCallOrigin();
@@ -344,18 +352,14 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 
 	if (index >= 0) {
 		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
+		varIndex = index;
 		return kSelectorVariable;
 	} else {
 		// Check if it's a method, with recursive lookup in superclasses
 		while (obj) {
 			index = obj->funcSelectorPosition(selectorId);
 			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
+				func = obj->getFunction(index);
 
 				return kSelectorMethod;
 			} else {
@@ -370,4 +374,33 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 //	return _lookupSelector_function(segMan, obj, selectorId, fptr);
 }
 
+SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
+
+	// Early SCI versions used the LSB in the selector ID as a read/write
+	// toggle, meaning that we must remove it for selector lookup.
+	if (oldScriptHeader)
+		selectorId &= ~1;
+
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	SelectorType type;
+	uint16 varIndex;
+	reg_t func;
+	if (!cache.lookup(obj_location, selectorId, type, varIndex, func)) {
+		type = lookupSelectorUncached(segMan, obj_location, selectorId, varIndex, func);
+		cache.store(obj_location, selectorId, type, varIndex, func);
+	}
+
+	if (type == kSelectorVariable) {
+		if (varp) {
+			varp->obj = obj_location;
+			varp->varindex = varIndex;
+		}
+	} else if (type == kSelectorMethod) {
+		if (fptr)
+			*fptr = func;
+	}
+	return type;
+}
+
 } // End of namespace Sci
@@ -199,6 +199,98 @@ struct SelectorCache {
 #endif
 };
 
+/**
+ * Caches the results of lookupSelector() per object and selector, so that
+ * repeated sends to the same object don't have to search its variable
+ * selectors and walk its superclass chain every time. The cache is direct
+ * mapped: a new lookup simply replaces the entry it maps to.
+ *
+ * The results only depend on the object's class hierarchy, which is fixed
+ * while the object exists. The cache therefore has to be invalidated when
+ * scripts are loaded or unloaded and when clones are freed. A new clone
+ * needs no invalidation: its address was either never used, or the clone
+ * which used it before was freed. This is done by the segment manager.
+ */
+class SelectorLookupCache {
+public:
+	SelectorLookupCache();
+
+	/**
+	 * Forgets all cached lookups.
+	 */
+	void invalidate() {
+		if (++_generation == 0)
+			reset();
+		++_invalidations;
+	}
+
+	/**
+	 * Looks up the cached result for the given object and selector.
+	 * @return true on a cache hit
+	 */
+	bool lookup(reg_t obj, Selector selectorId, SelectorType &type, uint16 &varIndex, reg_t &func) {
+		const Entry &entry = _entries[getIndex(obj, selectorId)];
+		if (entry.generation != _generation || entry.selector != selectorId || entry.obj != obj) {
+			++_misses;
+			return false;
+		}
+
+		++_hits;
+		type = entry.type;
+		varIndex = entry.varIndex;
+		func = entry.func;
+		return true;
+	}
+
+	/**
+	 * Stores the result of a lookup.
+	 */
+	void store(reg_t obj, Selector selectorId, SelectorType type, uint16 varIndex, reg_t func) {
+		Entry &entry = _entries[getIndex(obj, selectorId)];
+		entry.obj = obj;
+		entry.selector = selectorId;
+		entry.generation = _generation;
+		entry.type = type;
+		entry.varIndex = varIndex;
+		entry.func = func;
+	}
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getInvalidations() const { return _invalidations; }
+	void resetStats() { _hits = _misses = _invalidations = 0; }
+
+private:
+	enum {
+		kCacheSize = 4096 ///< Number of entries, must be a power of two
+	};
+
+	struct Entry {
+		reg_t obj;
+		Selector selector;
+		uint32 generation;
+		SelectorType type;
+		uint16 varIndex;
+		reg_t func;
+	};
+
+	uint getIndex(reg_t obj, Selector selectorId) const {
+		return (obj._segment * 0x9E3779B1 ^ obj._offset * 0x85EBCA6B ^ (uint16)selectorId * 0xC2B2AE35) >> 20 & (kCacheSize - 1);
+	}
+
+	/** Clears all entries, for when the generation counter wraps around */
+	void reset();
+
+	Entry _entries[kCacheSize];
+
+	/** Entries from older generations are invalid */
+	uint32 _generation;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _invalidations;
+};
+
 /**
  * Map a selector name to a selector id. Shortcut for accessing the selector cache.
  */
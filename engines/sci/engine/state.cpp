@@ -24,6 +24,7 @@
 #include "sci/sci.h"	// for INCLUDE_OLDGFX
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -68,12 +69,15 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan),
-	_dirseeker() {
+	_dirseeker(),
+	_incrementalGC(nullptr) {
 
 	reset(false);
 }
 
 EngineState::~EngineState() {
+	// The SegManager is gone already
+	delete _incrementalGC;
 	delete _msgState;
 }
 
@@ -100,6 +104,8 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	gcNurseryCountDown = GC_NURSERY_INTERVAL;
+	abort_gc(this);
 
 #ifdef ENABLE_SCI32
 	_eventCounter = 0;
@@ -117,6 +123,7 @@ void EngineState::reset(bool isRestoring) {
 
 	scriptStepCounter = 0;
 	scriptGCInterval = GC_INTERVAL;
+	gcIncremental = true;
 }
 
 void EngineState::speedThrottler(uint32 neededSleep) {
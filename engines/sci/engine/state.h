@@ -45,6 +45,7 @@ namespace Sci {
 
 class FileHandle;
 class DirSeeker;
+struct IncrementalGC;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
@@ -98,6 +99,98 @@ struct SciCallOrigin {
 	}
 };
 
+/**
+ * Statistics on the garbage collector runs, shown by the gc_stats console
+ * command. The pause of an incremental collection is the one of its final
+ * step, which finishes marking and frees what is unreachable.
+ */
+struct GCStatistics {
+	uint32 runs; /**< Number of collections */
+	uint32 totalTime; /**< Total pause time of the collections, in milliseconds */
+	uint32 maxTime; /**< Longest pause of a collection, in milliseconds */
+	uint32 lastTime; /**< Pause of the last collection, in milliseconds */
+	uint32 lastReachable; /**< Number of reachable addresses found by the last collection */
+	uint32 lastFreed; /**< Number of entries freed by the last collection */
+	uint32 totalFreed; /**< Number of entries freed by all collections */
+	uint32 markSteps; /**< Number of incremental marking steps */
+	uint32 maxMarkStepTime; /**< Longest incremental marking step, in milliseconds */
+	uint32 remarks; /**< Incremental collections which had to mark everything again at the end */
+	uint32 minorRuns; /**< Number of nursery collections */
+	uint32 minorTotalTime; /**< Total pause time of the nursery collections, in milliseconds */
+	uint32 minorMaxTime; /**< Longest pause of a nursery collection, in milliseconds */
+	uint32 minorFreed; /**< Number of arrays freed by all nursery collections */
+
+	GCStatistics() { reset(); }
+	void reset() {
+		runs = totalTime = maxTime = lastTime = 0;
+		lastReachable = lastFreed = totalFreed = 0;
+		markSteps = maxMarkStepTime = remarks = 0;
+		minorRuns = minorTotalTime = minorMaxTime = minorFreed = 0;
+	}
+};
+
+/**
+ * Visibility between the vertices of the most recently used polygon sets,
+ * which is filled in lazily by the pathfinder (see kpathing.cpp). Entries
+ * are identified by the polygon geometry itself, so they never go stale.
+ */
+struct VisibilityCache {
+	enum {
+		kEntryCount = 4,
+		kMaxVertices = 256
+	};
+
+	enum {
+		kUnknown = 0,
+		kVisible = 1,
+		kBlocked = 2
+	};
+
+	struct Entry {
+		uint32 hash;
+		uint32 lastUse;
+		uint vertexCount;
+		Common::Array<int16> geometry; /**< Vertex count and coordinates of each polygon */
+		Common::Array<byte> visibility; /**< vertexCount * vertexCount, kUnknown, kVisible or kBlocked */
+
+		Entry() : hash(0), lastUse(0), vertexCount(0) {}
+	};
+
+	Entry entries[kEntryCount];
+	uint32 useCounter;
+
+	VisibilityCache() : useCounter(0) {}
+
+	/**
+	 * Returns the visibility table for the given polygon geometry, replacing
+	 * the least recently used entry if it is not cached yet.
+	 */
+	Common::Array<byte> &getVisibility(const Common::Array<int16> &geometry, uint vertexCount) {
+		uint32 hash = 2166136261u;
+		for (uint i = 0; i < geometry.size(); ++i)
+			hash = (hash ^ (uint16)geometry[i]) * 16777619u;
+
+		Entry *oldest = &entries[0];
+		for (uint i = 0; i < kEntryCount; ++i) {
+			Entry &entry = entries[i];
+			if (entry.hash == hash && entry.vertexCount == vertexCount && entry.geometry == geometry) {
+				entry.lastUse = ++useCounter;
+				return entry.visibility;
+			}
+			if (entry.lastUse < oldest->lastUse)
+				oldest = &entry;
+		}
+
+		oldest->hash = hash;
+		oldest->lastUse = ++useCounter;
+		oldest->vertexCount = vertexCount;
+		oldest->geometry = geometry;
+		oldest->visibility.clear();
+		oldest->visibility.resize(vertexCount * vertexCount);
+		return oldest->visibility;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -190,6 +283,12 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	int gcNurseryCountDown; /**< Number of kernel calls until the array nursery is collected */
+	bool gcIncremental; /**< Whether gcs mark a slice at a time instead of all at once */
+	IncrementalGC *_incrementalGC; /**< The incremental gc in progress, if any */
+	GCStatistics gcStats;
+
+	VisibilityCache _visibilityCache; /**< Used by kAvoidPath */
 
 	MessageState *_msgState;
 
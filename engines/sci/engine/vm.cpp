@@ -48,6 +48,11 @@ const reg_t TRUE_REG = {0, 1};
 // to an infinite loop). Aids in detecting script bugs such as #3040722.
 //#define ABORT_ON_INFINITE_LOOP
 
+// Enable the define below to have the VM check each instruction it takes
+// from a script's table of decoded instructions against a fresh decode of
+// the bytecode.
+//#define VERIFY_DECODED_INSTRUCTIONS
+
 // validation functionality
 
 static reg_t &validate_property(EngineState *s, Object *obj, int index) {
@@ -188,6 +193,7 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 				if (lookupSelector(s->_segMan, stopGroopPos, SELECTOR(client), &varp, NULL) == kSelectorVariable) {
 					reg_t *clientVar = varp.getPointer(s->_segMan);
 					*clientVar = value;
+					s->_segMan->writeBarrier(value);
 				}
 			}
 		}
@@ -200,6 +206,10 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 			value.setSegment(0);
 
 		s->variables[type][index] = value;
+		// Temporaries and parameters live on the stack, which the garbage
+		// collector scans anyway
+		if (type == VAR_GLOBAL || type == VAR_LOCAL)
+			s->_segMan->writeBarrier(value);
 
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
 	}
@@ -249,6 +259,7 @@ static void _exec_varselectors(EngineState *s) {
 			// varselector access?
 			if (xs.argc) { // write?
 				*var = xs.variables_argp[1];
+				s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 				updateInfoFlagViewVisible(s->_segMan->getObject(xs.addr.varp.obj), xs.addr.varp.varindex);
@@ -659,7 +670,17 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+#ifdef VERIFY_DECODED_INSTRUCTIONS
+		byte verifyExtOpcode;
+		int16 verifyOpparams[4];
+		const int verifySize = readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), verifyExtOpcode, verifyOpparams);
+		const uint32 instructionOffset = s->xs->addr.pc.getOffset();
+#endif
+		s->xs->addr.pc.incOffset(scr->decodeInstruction(s->xs->addr.pc.getOffset(), extOpcode, opparams));
+#ifdef VERIFY_DECODED_INSTRUCTIONS
+		if (verifySize != (int)(s->xs->addr.pc.getOffset() - instructionOffset) || verifyExtOpcode != extOpcode || memcmp(verifyOpparams, opparams, sizeof(verifyOpparams)))
+			error("Decoded instruction mismatch in script %d at %04x", scr->getScriptNumber(), instructionOffset);
+#endif
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -883,10 +904,7 @@ void run_vm(EngineState *s) {
 
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
-			}
+			run_gc_step(s);
 
 			// Call kernel function
 			s->xs->sp -= (opparams[1] >> 1) + 1;
@@ -967,6 +985,7 @@ void run_vm(EngineState *s) {
 					reg_t *var = old_xs->getVarPointer(s->_segMan);
 					if (old_xs->argc) { // write?
 						*var = old_xs->variables_argp[1];
+						s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 						updateInfoFlagViewVisible(s->_segMan->getObject(old_xs->addr.varp.obj), old_xs->addr.varp.varindex);
@@ -1153,6 +1172,7 @@ void run_vm(EngineState *s) {
 			}
 
 			opProperty = s->r_acc;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1183,6 +1203,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 			opProperty = newValue;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1209,6 +1230,7 @@ void run_vm(EngineState *s) {
 				opProperty += 1;
 			else
 				opProperty -= 1;
+			s->_segMan->writeBarrier(opProperty);
 
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORWRITE) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
@@ -183,9 +183,10 @@ enum GlobalVar {
 	kGlobalVarHoyle5ResponseTime  = 899
 };
 
-/** Number of kernel calls in between gcs; should be < 50000 */
 enum {
-	GC_INTERVAL = 0x8000
+	GC_INTERVAL = 0x8000, /**< Number of kernel calls in between gcs; should be < 50000 */
+	GC_NURSERY_INTERVAL = 0x400, /**< Number of kernel calls in between collections of the array nursery */
+	GC_MARK_SLICE = 0x100 /**< Number of addresses an incremental gc marks per kernel call */
 };
 
 enum SciOpcodes {
@@ -35,6 +35,14 @@
 #include "common/config-manager.h"
 #include "common/gui_options.h"
 
+#if defined(__SSE2__)
+#define CELOBJ_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CELOBJ_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Sci {
 #pragma mark CelScaler
 
@@ -44,12 +52,19 @@ void CelScaler::activateScaleTables(const Ratio &scaleX, const Ratio &scaleY) {
 	for (int i = 0; i < ARRAYSIZE(_scaleTables); ++i) {
 		if (_scaleTables[i].scaleX == scaleX && _scaleTables[i].scaleY == scaleY) {
 			_activeIndex = i;
+			_lastUse[i] = ++_useCounter;
 			return;
 		}
 	}
 
-	const int i = 1 - _activeIndex;
+	int i = 0;
+	for (int j = 1; j < ARRAYSIZE(_scaleTables); ++j) {
+		if (_lastUse[j] < _lastUse[i]) {
+			i = j;
+		}
+	}
 	_activeIndex = i;
+	_lastUse[i] = ++_useCounter;
 	CelScalerTable &table = _scaleTables[i];
 
 	if (table.scaleX != scaleX) {
@@ -91,12 +106,15 @@ void CelObj::init() {
 	_drawBlackLines = false;
 	_nextCacheId = 1;
 	_scaler.reset(new CelScaler());
-	_cache.reset(new CelCache(100));
+	_cache.reset(new CelCache(kCelCacheSize));
+	_cacheIndex.reset(new CelCacheIndex());
+	resetCacheStats();
 }
 
 void CelObj::deinit() {
 	_scaler.reset();
 	_cache.reset();
+	_cacheIndex.reset();
 }
 
 #pragma mark -
@@ -147,6 +165,18 @@ struct SCALER_NoScale {
 			return *_row++;
 		}
 	}
+
+	/**
+	 * Returns the next `count` source pixels of the current row. Only
+	 * available when the row is read front to back.
+	 */
+	inline const byte *readRow(const int16 count) {
+		STATIC_ASSERT(!FLIP, readRow_needs_unflipped_rows);
+		const byte *row = _row;
+		_row += count;
+		assert(_row <= _rowEdge);
+		return row;
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -436,6 +466,50 @@ public:
 #pragma mark -
 #pragma mark CelObj - Remappers
 
+/**
+ * Copies `width` pixels from `source` to `target`, leaving the target pixel
+ * alone wherever the source pixel is `skipColor` or, if `LIMIT` is set, at or
+ * above `limit`. Where available, this uses SSE2 or NEON.
+ */
+template<bool LIMIT>
+static inline void copyPixels(byte *target, const byte *source, const int16 width, const uint8 skipColor, const uint8 limit) {
+	int16 x = 0;
+
+#if defined(CELOBJ_SSE2)
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+	const __m128i end = _mm_set1_epi8((char)limit);
+	const __m128i zero = _mm_setzero_si128();
+	for (; x + 16 <= width; x += 16) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(source + x));
+		__m128i keep = _mm_cmpeq_epi8(pixels, skip);
+		if (LIMIT) {
+			// The saturating difference is zero for pixels >= limit
+			keep = _mm_or_si128(keep, _mm_cmpeq_epi8(_mm_subs_epu8(end, pixels), zero));
+		}
+		const __m128i old = _mm_loadu_si128((const __m128i *)(target + x));
+		_mm_storeu_si128((__m128i *)(target + x), _mm_or_si128(_mm_and_si128(keep, old), _mm_andnot_si128(keep, pixels)));
+	}
+#elif defined(CELOBJ_NEON)
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+	const uint8x16_t end = vdupq_n_u8(limit);
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t pixels = vld1q_u8(source + x);
+		uint8x16_t keep = vceqq_u8(pixels, skip);
+		if (LIMIT) {
+			keep = vorrq_u8(keep, vcgeq_u8(pixels, end));
+		}
+		vst1q_u8(target + x, vbslq_u8(keep, vld1q_u8(target + x), pixels));
+	}
+#endif
+
+	for (; x < width; ++x) {
+		const byte pixel = source[x];
+		if (pixel != skipColor && (!LIMIT || pixel < limit)) {
+			target[x] = pixel;
+		}
+	}
+}
+
 /**
  * Pixel mapper for a CelObj with transparent pixels and no
  * remapping data.
@@ -446,6 +520,10 @@ struct MAPPER_NoMD {
 			*target = pixel;
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		copyPixels<false>(target, source, width, skipColor, 0);
+	}
 };
 
 /**
@@ -456,6 +534,10 @@ struct MAPPER_NoMDNoSkip {
 	inline void draw(byte *target, const byte pixel, const uint8) const {
 		*target = pixel;
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8) const {
+		memcpy(target, source, width);
+	}
 };
 
 /**
@@ -463,14 +545,34 @@ struct MAPPER_NoMDNoSkip {
  * remapping data, and remapping enabled.
  */
 struct MAPPER_Map {
+	const GfxRemap32 *const _remap;
+	const uint8 _startColor;
+
+	MAPPER_Map() :
+		_remap(g_sci->_gfxRemap32),
+		_startColor(_remap->getStartColor()) {}
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor) const {
 		if (pixel != skipColor) {
 			// For some reason, SSCI never checks if the source pixel is *above*
 			// the range of remaps, so we do not either.
-			if (pixel < g_sci->_gfxRemap32->getStartColor()) {
+			if (pixel < _startColor) {
 				*target = pixel;
-			} else if (g_sci->_gfxRemap32->remapEnabled(pixel)) {
-				*target = g_sci->_gfxRemap32->remapColor(pixel, *target);
+			} else if (_remap->remapEnabled(pixel)) {
+				*target = _remap->remapColor(pixel, *target);
+			}
+		}
+	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		// Every pixel only depends on its own source and target, so the
+		// plain pixels can be copied first and the remapped ones applied
+		// afterwards
+		copyPixels<true>(target, source, width, skipColor, _startColor);
+		for (int16 x = 0; x < width; ++x) {
+			const byte pixel = source[x];
+			if (pixel != skipColor && pixel >= _startColor && _remap->remapEnabled(pixel)) {
+				target[x] = _remap->remapColor(pixel, target[x]);
 			}
 		}
 	}
@@ -481,13 +583,22 @@ struct MAPPER_Map {
  * remapping data, and remapping disabled.
  */
 struct MAPPER_NoMap {
+	const uint8 _startColor;
+
+	MAPPER_NoMap() :
+		_startColor(g_sci->_gfxRemap32->getStartColor()) {}
+
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor) const {
 		// For some reason, SSCI never checks if the source pixel is *above* the
 		// range of remaps, so we do not either.
-		if (pixel != skipColor && pixel < g_sci->_gfxRemap32->getStartColor()) {
+		if (pixel != skipColor && pixel < _startColor) {
 			*target = pixel;
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		copyPixels<true>(target, source, width, skipColor, _startColor);
+	}
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
@@ -666,32 +777,48 @@ void CelObj::submitPalette() const {
 
 int CelObj::_nextCacheId = 1;
 Common::ScopedPtr<CelCache> CelObj::_cache;
+Common::ScopedPtr<CelCacheIndex> CelObj::_cacheIndex;
+uint32 CelObj::_cacheHits = 0;
+uint32 CelObj::_cacheMisses = 0;
+
+uint CelObj::getCacheCapacity() {
+	return _cache ? _cache->size() : 0;
+}
+
+uint CelObj::getCacheSize() {
+	return _cacheIndex ? _cacheIndex->size() : 0;
+}
 
 int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
 	*nextInsertIndex = -1;
+
+	CelCacheIndex::const_iterator it = _cacheIndex->find(celInfo);
+	if (it != _cacheIndex->end()) {
+		++_cacheHits;
+		(*_cache)[it->_value].id = ++_nextCacheId;
+		return it->_value;
+	}
+
+	++_cacheMisses;
+
+	// The slot to replace is only needed when the cel has to be read from its
+	// resource, which is much more expensive than this scan
 	int oldestId = _nextCacheId + 1;
 	int oldestIndex = 0;
 
 	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+		const CelCacheEntry &entry = (*_cache)[i];
 
 		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
+			*nextInsertIndex = i;
+			return -1;
 		} else if (oldestId > entry.id) {
 			oldestId = entry.id;
 			oldestIndex = i;
 		}
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
-	}
-
+	*nextInsertIndex = oldestIndex;
 	return -1;
 }
 
@@ -701,13 +828,48 @@ void CelObj::putCopyInCache(const int cacheIndex) const {
 	}
 
 	CelCacheEntry &entry = (*_cache)[cacheIndex];
+
+	// The constructors may have corrected the loop and cel numbers, so the
+	// same cel can end up in more than one slot; only drop the index entry
+	// if it still refers to the slot being replaced
+	if (entry.celObj != nullptr) {
+		CelCacheIndex::iterator it = _cacheIndex->find(entry.celObj->_info);
+		if (it != _cacheIndex->end() && it->_value == cacheIndex) {
+			_cacheIndex->erase(it);
+		}
+	}
+
 	entry.celObj.reset(duplicate());
 	entry.id = ++_nextCacheId;
+	(*_cacheIndex)[_info] = cacheIndex;
 }
 
 #pragma mark -
 #pragma mark CelObj - Drawing
 
+/**
+ * Draws one row of a cel, one pixel at a time.
+ */
+template<typename MAPPER, typename SCALER>
+struct ROW_RENDERER {
+	static inline void draw(const MAPPER &mapper, SCALER &scaler, byte *target, const int16 width, const uint8 skipColor) {
+		for (int16 x = 0; x < width; ++x) {
+			mapper.draw(target++, scaler.read(), skipColor);
+		}
+	}
+};
+
+/**
+ * Unscaled and unflipped cels read each row front to back, so the mapper can
+ * process the whole row at once.
+ */
+template<typename MAPPER, typename READER>
+struct ROW_RENDERER<MAPPER, SCALER_NoScale<false, READER> > {
+	static inline void draw(const MAPPER &mapper, SCALER_NoScale<false, READER> &scaler, byte *target, const int16 width, const uint8 skipColor) {
+		mapper.drawRow(target, scaler.readRow(width), width, skipColor);
+	}
+};
+
 template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
 struct RENDERER {
 	MAPPER &_mapper;
@@ -733,12 +895,8 @@ struct RENDERER {
 			}
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
-
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor);
-			}
-
-			targetPixel += skipStride;
+			ROW_RENDERER<MAPPER, SCALER>::draw(_mapper, _scaler, targetPixel, targetWidth, _skipColor);
+			targetPixel += targetWidth + skipStride;
 		}
 	}
 };
@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource.h"
@@ -105,7 +106,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -115,7 +116,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -138,6 +139,16 @@ struct CelInfo32 {
 	}
 };
 
+enum {
+	/**
+	 * The number of cel objects kept in the cel cache. SSCI used 100 slots,
+	 * which busy SCI2.1 and SCI3 scenes with many animated screen items
+	 * exceed. A cached cel object is small, since it does not hold any pixel
+	 * data.
+	 */
+	kCelCacheSize = 256
+};
+
 class CelObj;
 struct CelCacheEntry {
 	/**
@@ -151,6 +162,19 @@ struct CelCacheEntry {
 
 typedef Common::Array<CelCacheEntry> CelCache;
 
+struct CelInfo32Hash : public Common::UnaryFunction<CelInfo32, uint> {
+	uint operator()(const CelInfo32 &info) const {
+		return ((uint)info.type << 28) ^ ((uint)info.resourceId << 12) ^
+			((uint)info.loopNo << 6) ^ (uint)info.celNo ^
+			((uint)info.bitmap.getSegment() << 16) ^ info.bitmap.getOffset();
+	}
+};
+
+/**
+ * Maps the CelInfo32 of each cached cel object to its slot in the CelCache.
+ */
+typedef Common::HashMap<CelInfo32, int, CelInfo32Hash> CelCacheIndex;
+
 #pragma mark -
 #pragma mark CelScaler
 
@@ -189,9 +213,22 @@ struct CelScalerTable {
 
 class CelScaler {
 	/**
-	 * Cached scale tables.
+	 * Cached scale tables. Screen items are usually drawn at a handful of
+	 * different scales, so keeping a few tables around avoids rebuilding them
+	 * for every other item.
+	 */
+	CelScalerTable _scaleTables[4];
+
+	/**
+	 * The value of `_useCounter` when each scale table was last activated.
+	 */
+	uint _lastUse[ARRAYSIZE(_scaleTables)];
+
+	/**
+	 * A monotonically increasing counter used to find the least recently used
+	 * scale table.
 	 */
-	CelScalerTable _scaleTables[2];
+	uint _useCounter;
 
 	/**
 	 * The index of the most recently used scale table.
@@ -215,6 +252,8 @@ class CelScaler {
 public:
 	CelScaler() :
 		_scaleTables(),
+		_lastUse(),
+		_useCounter(0),
 		_activeIndex(0) {
 		CelScalerTable &table = _scaleTables[0];
 		table.scaleX = Ratio();
@@ -345,6 +384,30 @@ public:
 	 */
 	static void deinit();
 
+	/**
+	 * Returns the number of constructions of view and pic cel objects which
+	 * were satisfied from the cel cache.
+	 */
+	static uint32 getCacheHits() { return _cacheHits; }
+
+	/**
+	 * Returns the number of constructions of view and pic cel objects which
+	 * had to read the cel from its resource.
+	 */
+	static uint32 getCacheMisses() { return _cacheMisses; }
+
+	/**
+	 * Returns the number of cel objects the cel cache can hold, and how many
+	 * it currently holds.
+	 */
+	static uint getCacheCapacity();
+	static uint getCacheSize();
+
+	/**
+	 * Resets the cel cache statistics.
+	 */
+	static void resetCacheStats() { _cacheHits = _cacheMisses = 0; }
+
 	virtual ~CelObj() {};
 
 	/**
@@ -459,11 +522,23 @@ protected:
 	 */
 	static Common::ScopedPtr<CelCache> _cache;
 
+	/**
+	 * The cache slots of the cel objects in `_cache`, keyed by their
+	 * CelInfo32.
+	 */
+	static Common::ScopedPtr<CelCacheIndex> _cacheIndex;
+
+	/**
+	 * Cache lookup statistics, shown by the `cel_cache` debugger command.
+	 */
+	static uint32 _cacheHits;
+	static uint32 _cacheMisses;
+
 	/**
 	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * not found, -1 is returned and `nextInsertIndex` will receive the index of
+	 * a free slot or of the oldest item in the cache, which can be used to
+	 * replace the oldest item with a newer item.
 	 */
 	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
 
@@ -207,6 +207,7 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_fileOffset = 0;
 	_status = kResStatusNoMalloc;
 	_lockers = 0;
+	_lruSegment = 0;
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
@@ -975,8 +976,11 @@ ResourceManager::ResourceManager(const bool detectionMode) :
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
-	_memoryLRU = 0;
-	_LRU.clear();
+	for (int i = 0; i < kLRUSegmentCount; ++i) {
+		_memoryLRU[i] = 0;
+		_LRU[i].clear();
+	}
+	resetCacheStatistics();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1084,13 +1088,35 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+ResourceManager::LRUSegment ResourceManager::getLRUSegment(const Resource *res) const {
+	switch (res->getType()) {
+	case kResourceTypeAudio:
+	case kResourceTypeAudio36:
+	case kResourceTypeSync:
+	case kResourceTypeSync36:
+	case kResourceTypeCdAudio:
+	case kResourceTypeRave:
+	case kResourceTypeRobot:
+	case kResourceTypeVMD:
+	case kResourceTypeDuck:
+		return kLRUSegmentLarge;
+	default:
+		break;
+	}
+
+	if ((int)res->size() > _maxMemoryLRU / 16)
+		return kLRUSegmentLarge;
+
+	return kLRUSegmentSmall;
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
-	_memoryLRU -= res->size();
+	_LRU[res->_lruSegment].erase(res->_lruPosition);
+	_memoryLRU[res->_lruSegment] -= res->size();
 	res->_status = kResStatusAllocated;
 }
 
@@ -1099,45 +1125,67 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
-	_memoryLRU += res->size();
+	const LRUSegment segment = getLRUSegment(res);
+	_LRU[segment].push_front(res);
+	res->_lruPosition = _LRU[segment].begin();
+	res->_lruSegment = segment;
+	_memoryLRU[segment] += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
 	      res->_id.toString().c_str(), res->size,
-	      _memoryLRU);
+	      _memoryLRU[segment]);
 #endif
 	res->_status = kResStatusEnqueued;
 }
 
 void ResourceManager::printLRU() {
-	int mem = 0;
-	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
+	for (int segment = 0; segment < kLRUSegmentCount; ++segment) {
+		int mem = 0;
+		int entries = 0;
+		Common::List<Resource *>::iterator it = _LRU[segment].begin();
+		Resource *res;
+
+		while (it != _LRU[segment].end()) {
+			res = *it;
+			debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
+			mem += res->size();
+			++entries;
+			++it;
+		}
+
+		debug("Segment %d: %d entries, %d bytes (mgr says %d)", segment, entries, mem, _memoryLRU[segment]);
 	}
+}
 
-	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
+int ResourceManager::getLRUShare(LRUSegment segment) const {
+	// The large segment gets a quarter of the budget, so that a few speech
+	// clips don't push out the views and scripts the game keeps reusing
+	if (segment == kLRUSegmentLarge)
+		return _maxMemoryLRU / 4;
+	return _maxMemoryLRU - _maxMemoryLRU / 4;
 }
 
 void ResourceManager::freeOldResources() {
-	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+	// A segment may use the room the other one leaves, but once the total is
+	// over budget, the segment which is over its share has to give it back
+	while (_maxMemoryLRU < _memoryLRU[kLRUSegmentSmall] + _memoryLRU[kLRUSegmentLarge]) {
+		const LRUSegment segment = _memoryLRU[kLRUSegmentLarge] > getLRUShare(kLRUSegmentLarge) ? kLRUSegmentLarge : kLRUSegmentSmall;
+		assert(!_LRU[segment].empty());
+		Resource *goner = _LRU[segment].back();
 		removeFromLRU(goner);
 		goner->unalloc();
+		if (goner->getType() < kResourceTypeInvalid)
+			_cacheStats[goner->getType()].evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
 	}
 }
 
+void ResourceManager::resetCacheStatistics() {
+	memset(_cacheStats, 0, sizeof(_cacheStats));
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1174,6 +1222,13 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
+	if (retval->getType() < kResourceTypeInvalid) {
+		if (retval->_status == kResStatusNoMalloc)
+			_cacheStats[retval->getType()].misses++;
+		else
+			_cacheStats[retval->getType()].hits++;
+	}
+
 	if (retval->_status == kResStatusNoMalloc)
 		loadResource(retval);
 	else if (retval->_status == kResStatusEnqueued)
@@ -298,6 +298,8 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Common::List<Resource *>::iterator _lruPosition; /**< Position in its LRU segment while enqueued */
+	byte _lruSegment; /**< LRU segment the resource is enqueued in */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -331,6 +333,20 @@ class ResourceManager {
 #endif
 
 public:
+	/** Segments of the LRU cache of unlocked resources */
+	enum LRUSegment {
+		kLRUSegmentSmall = 0, ///< Views, scripts and other small, often reused resources
+		kLRUSegmentLarge,     ///< Audio, videos and resources large compared to the budget
+		kLRUSegmentCount
+	};
+
+	/** Cache statistics for a resource type */
+	struct CacheStatistics {
+		uint32 hits;      ///< Lookups answered from memory
+		uint32 misses;    ///< Lookups which had to load the resource
+		uint32 evictions; ///< Resources freed to stay within the LRU budget
+	};
+
 	/**
 	 * Creates a new SCI resource manager.
 	 */
@@ -369,6 +385,15 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	const CacheStatistics &getCacheStatistics(ResourceType type) const { return _cacheStats[type]; }
+	void resetCacheStatistics();
+
+	int getLRUMemory(LRUSegment segment) const { return _memoryLRU[segment]; }
+	uint getLRUEntries(LRUSegment segment) const { return _LRU[segment].size(); }
+	int getMaxLRUMemory() const { return _maxMemoryLRU; }
+	int getLRUShare(LRUSegment segment) const;
+	int getLockedMemory() const { return _memoryLocked; }
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -476,7 +501,8 @@ public:
 protected:
 	bool _detectionMode;
 
-	// Maximum number of bytes to allow being allocated for resources
+	// Maximum number of bytes to allow being allocated for resources, shared
+	// by the LRU segments (see getLRUShare())
 	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
 	// for resources which are not explicitly locked. However, a warning will be
 	// issued whenever this limit is exceeded.
@@ -486,8 +512,9 @@ protected:
 	typedef Common::List<ResourceSource *> SourcesList;
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
-	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	int _memoryLRU[kLRUSegmentCount];		///< Amount of resource bytes under LRU control, per segment
+	Common::List<Resource *> _LRU[kLRUSegmentCount]; ///< Last Resource Used lists, most recent first
+	CacheStatistics _cacheStats[kResourceTypeInvalid];
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -623,6 +650,13 @@ protected:
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
 
+	/**
+	 * Determines the LRU segment for a resource. Streamed media and anything
+	 * large compared to the cache budget go to their own segment, so that
+	 * they cannot push the small, frequently used views and scripts out.
+	 */
+	LRUSegment getLRUSegment(const Resource *res) const;
+
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
 	bool hasSci0Voc999();
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/debug-channels.h"
 #include "common/file.h"
 #include "common/str.h"
@@ -37,6 +38,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -93,6 +96,8 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 
 	registerCmd("show",      WRAP_METHOD(ScummDebugger, Cmd_Show));
 	registerCmd("hide",      WRAP_METHOD(ScummDebugger, Cmd_Hide));
+	registerCmd("opcodes",   WRAP_METHOD(ScummDebugger, Cmd_Opcodes));
+	registerCmd("resources", WRAP_METHOD(ScummDebugger, Cmd_Resources));
 
 	registerCmd("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
@@ -253,6 +258,82 @@ bool ScummDebugger::Cmd_Hide(int argc, const char **argv) {
 	return true;
 }
 
+struct OpcodeCountGreater {
+	const uint32 *_counts;
+	OpcodeCountGreater(const uint32 *counts) : _counts(counts) {}
+	bool operator()(int a, int b) const { return _counts[a] > _counts[b]; }
+};
+
+bool ScummDebugger::Cmd_Opcodes(int argc, const char **argv) {
+	if (argc == 2) {
+		if (!strcmp(argv[1], "on")) {
+			_vm->_profileOpcodes = true;
+			debugPrintf("Opcode profiling on\n");
+		} else if (!strcmp(argv[1], "off")) {
+			_vm->_profileOpcodes = false;
+			debugPrintf("Opcode profiling off\n");
+		} else if (!strcmp(argv[1], "reset")) {
+			memset(_vm->_opcodeCounts, 0, sizeof(_vm->_opcodeCounts));
+			debugPrintf("Opcode counts reset\n");
+		} else {
+			debugPrintf("Syntax: opcodes [on | off | reset]\n");
+		}
+		return true;
+	}
+
+	if (!_vm->_profileOpcodes)
+		debugPrintf("Opcode profiling is off, use 'opcodes on' to start it\n");
+
+	int order[256];
+	uint32 total = 0;
+	for (int i = 0; i < 256; i++) {
+		order[i] = i;
+		total += _vm->_opcodeCounts[i];
+	}
+	Common::sort(order, order + 256, OpcodeCountGreater(_vm->_opcodeCounts));
+
+	debugPrintf("%u opcodes executed\n", total);
+	for (int i = 0; i < 256 && _vm->_opcodeCounts[order[i]]; i++) {
+		const uint32 count = _vm->_opcodeCounts[order[i]];
+		debugPrintf("  [%02X] %-32s %10u  %5.1f%%\n", order[i], _vm->getOpcodeDesc(order[i]), count, count * 100.0 / total);
+	}
+	return true;
+}
+
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset")) {
+			res->resetStatistics();
+			debugPrintf("Resource statistics reset\n");
+		} else {
+			debugPrintf("Syntax: resources [reset]\n");
+		}
+		return true;
+	}
+
+	debugPrintf("Heap: %u bytes allocated, thresholds %u - %u, %u expire runs\n",
+		res->getAllocatedSize(), res->getMinHeapThreshold(), res->getMaxHeapThreshold(), res->getExpireRuns());
+	debugPrintf("  %-16s %6s %10s %8s %10s %8s %10s\n", "type", "loaded", "bytes", "loads", "bytes", "expired", "bytes");
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		uint32 loaded = 0, loadedSize = 0;
+		for (ResId idx = 0; idx < res->_types[type].size(); idx++) {
+			if (res->_types[type][idx]._address) {
+				loaded++;
+				loadedSize += res->_types[type][idx]._size;
+			}
+		}
+
+		const ResourceManager::TypeStatistics &stats = res->getTypeStatistics(type);
+		if (!loaded && !stats.loads)
+			continue;
+		debugPrintf("  %-16s %6u %10u %8u %10u %8u %10u\n", nameOfResType(type), loaded, loadedSize,
+			stats.loads, stats.loadedBytes, stats.expirations, stats.expiredBytes);
+	}
+	return true;
+}
+
 bool ScummDebugger::Cmd_Script(int argc, const char** argv) {
 	int scriptnum;
 
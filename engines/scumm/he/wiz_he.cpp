@@ -31,6 +31,7 @@
 #include "scumm/scumm.h"
 #include "scumm/util.h"
 #include "scumm/he/wiz_he.h"
+#include "scumm/he/wiz_span_he.h"
 #include "scumm/he/moonbase/moonbase.h"
 
 namespace Scumm {
@@ -704,6 +705,53 @@ void Wiz::write16BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, cons
 	}
 }
 
+/**
+ * Draws `count` pixels of the color at `dataPtr`, starting at `dstPtr` and
+ * moving by `dstInc` bytes. Returns the position after the run.
+ */
+template<int type>
+uint8 *Wiz::write16BitRun(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int count, int dstType, const uint8 *xmapPtr) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	// All destination types are little endian here
+	if (dstInc > 0) {
+		if (type == kWizXMap)
+			wizSpanBlendFill16(dstPtr, READ_LE_UINT16(dataPtr), count);
+		if (type == kWizCopy)
+			wizSpanFill16(dstPtr, READ_LE_UINT16(dataPtr), count);
+		return dstPtr + count * 2;
+	}
+#endif
+	while (count--) {
+		write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
+		dstPtr += dstInc;
+	}
+	return dstPtr;
+}
+
+/**
+ * Draws the `count` pixels at `dataPtr`, starting at `dstPtr` and moving by
+ * `dstInc` bytes. Returns the position after the pixels.
+ */
+template<int type>
+uint8 *Wiz::write16BitSpan(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int count, int dstType, const uint8 *xmapPtr) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	// All destination types are little endian here
+	if (dstInc > 0) {
+		if (type == kWizXMap)
+			wizSpanBlend16(dstPtr, dataPtr, count);
+		if (type == kWizCopy)
+			memcpy(dstPtr, dataPtr, count * 2);
+		return dstPtr + count * 2;
+	}
+#endif
+	while (count--) {
+		write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
+		dataPtr += 2;
+		dstPtr += dstInc;
+	}
+	return dstPtr;
+}
+
 template<int type>
 void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr) {
 	const uint8 *dataPtr, *dataPtrNext;
@@ -773,10 +821,7 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
-						dstPtr += dstInc;
-					}
+					dstPtr = write16BitRun<type>(dstPtr, dstInc, dataPtr, code, dstType, xmapPtr);
 					dataPtr += 2;
 				} else {
 					code = (code >> 2) + 1;
@@ -793,11 +838,8 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
-						dataPtr += 2;
-						dstPtr += dstInc;
-					}
+					dstPtr = write16BitSpan<type>(dstPtr, dstInc, dataPtr, code, dstType, xmapPtr);
+					dataPtr += code * 2;
 				}
 			}
 		}
@@ -805,6 +847,10 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 		dstPtr = dstPtrNext;
 	}
 }
+
+// NOTE: These templates are used outside this file. We don't want the compiler to optimize them away, so we need to explicitely instantiate them.
+template void Wiz::decompress16BitWizImage<kWizXMap>(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr);
+template void Wiz::decompress16BitWizImage<kWizCopy>(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr);
 #endif
 
 template<int type>
@@ -836,6 +882,61 @@ void Wiz::write8BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const
 	}
 }
 
+/**
+ * Draws `count` pixels of the color at `dataPtr`, starting at `dstPtr` and
+ * moving by `dstInc` bytes. Returns the position after the run.
+ */
+template<int type>
+uint8 *Wiz::write8BitRun(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int count, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	if (bitDepth == 1) {
+		if (type == kWizXMap) {
+			if (dstInc > 0) {
+				wizSpanXMapFill8(dstPtr, xmapPtr + *dataPtr * 256, count);
+				return dstPtr + count;
+			}
+		} else {
+			const uint8 color = (type == kWizRMap) ? palPtr[*dataPtr] : *dataPtr;
+			memset(dstInc > 0 ? dstPtr : dstPtr - count + 1, color, count);
+			return dstPtr + dstInc * count;
+		}
+	}
+#ifdef SCUMM_LITTLE_ENDIAN
+	// All destination types are little endian here
+	if (bitDepth == 2 && type == kWizXMap && dstInc > 0) {
+		wizSpanBlendFill16(dstPtr, READ_LE_UINT16(palPtr + *dataPtr * 2), count);
+		return dstPtr + count * 2;
+	}
+#endif
+	while (count--) {
+		write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
+		dstPtr += dstInc;
+	}
+	return dstPtr;
+}
+
+/**
+ * Draws the `count` pixels at `dataPtr`, starting at `dstPtr` and moving by
+ * `dstInc` bytes. Returns the position after the pixels.
+ */
+template<int type>
+uint8 *Wiz::write8BitSpan(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int count, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	if (bitDepth == 1 && dstInc > 0) {
+		if (type == kWizXMap)
+			wizSpanXMap8(dstPtr, dataPtr, xmapPtr, count);
+		if (type == kWizRMap)
+			wizSpanRemap8(dstPtr, dataPtr, palPtr, count);
+		if (type == kWizCopy)
+			memcpy(dstPtr, dataPtr, count);
+		return dstPtr + count;
+	}
+	while (count--) {
+		write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
+		dataPtr++;
+		dstPtr += dstInc;
+	}
+	return dstPtr;
+}
+
 template<int type>
 void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
 	const uint8 *dataPtr, *dataPtrNext;
@@ -907,10 +1008,7 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dstPtr += dstInc;
-					}
+					dstPtr = write8BitRun<type>(dstPtr, dstInc, dataPtr, code, dstType, palPtr, xmapPtr, bitDepth);
 					dataPtr++;
 				} else {
 					code = (code >> 2) + 1;
@@ -927,11 +1025,8 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dataPtr++;
-						dstPtr += dstInc;
-					}
+					dstPtr = write8BitSpan<type>(dstPtr, dstInc, dataPtr, code, dstType, palPtr, xmapPtr, bitDepth);
+					dataPtr += code;
 				}
 			}
 		}
@@ -1179,7 +1274,7 @@ static int wizPackType2(uint8 *dst, const uint8 *src, int srcPitch, const Common
 }
 #endif
 
-static int wizPackType1(uint8 *dst, const uint8 *src, int srcPitch, const Common::Rect& rCapt, uint8 transColor) {
+int Wiz::wizPackType1(uint8 *dst, const uint8 *src, int srcPitch, const Common::Rect& rCapt, uint8 transColor) {
 	debug(9, "wizPackType1(%d, [%d,%d,%d,%d])", transColor, rCapt.left, rCapt.top, rCapt.right, rCapt.bottom);
 	src += rCapt.top * srcPitch + rCapt.left;
 	int w = rCapt.width();
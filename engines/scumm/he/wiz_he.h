@@ -323,10 +323,22 @@ public:
 
 #ifdef USE_RGB_COLOR
 	template<int type> static void write16BitColor(uint8 *dst, const uint8 *src, int dstType, const uint8 *xmapPtr);
+	template<int type> static uint8 *write16BitRun(uint8 *dst, int dstInc, const uint8 *src, int count, int dstType, const uint8 *xmapPtr);
+	template<int type> static uint8 *write16BitSpan(uint8 *dst, int dstInc, const uint8 *src, int count, int dstType, const uint8 *xmapPtr);
 #endif
 	template<int type> static void write8BitColor(uint8 *dst, const uint8 *src, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
+	template<int type> static uint8 *write8BitRun(uint8 *dst, int dstInc, const uint8 *src, int count, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
+	template<int type> static uint8 *write8BitSpan(uint8 *dst, int dstInc, const uint8 *src, int count, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
 	static void writeColor(uint8 *dstPtr, int dstType, uint16 color);
 
+	/**
+	 * Compresses the rCapt part of an 8-bit image the way decompressWizImage
+	 * expects, with transColor transparent. The data is only written if dst
+	 * is set.
+	 * @return the size of the compressed data
+	 */
+	static int wizPackType1(uint8 *dst, const uint8 *src, int srcPitch, const Common::Rect& rCapt, uint8 transColor);
+
 	uint16 getWizPixelColor(const uint8 *data, int x, int y, int w, int h, uint8 bitDepth, uint16 color);
 	uint16 getRawWizPixelColor(const uint8 *data, int x, int y, int w, int h, uint8 bitDepth, uint16 color);
 	void computeWizHistogram(uint32 *histogram, const uint8 *data, const Common::Rect& rCapt);
@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/endian.h"
+
+#include "scumm/he/wiz_span_he.h"
+
+#if defined(__SSE2__) && defined(SCUMM_LITTLE_ENDIAN)
+#define WIZ_SPAN_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(SCUMM_LITTLE_ENDIAN)
+#define WIZ_SPAN_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Scumm {
+
+/** The RGB555 50/50 mix used by the translucent Wiz modes */
+static inline uint16 blend555(uint16 src, uint16 dst) {
+	return ((src >> 1) & 0x7DEF) + ((dst >> 1) & 0x7DEF);
+}
+
+void wizSpanFill16(uint8 *dst, uint16 color, int count) {
+#if defined(WIZ_SPAN_SSE2)
+	const __m128i colors = _mm_set1_epi16((short)color);
+	for (; count >= 8; count -= 8, dst += 16)
+		_mm_storeu_si128((__m128i *)dst, colors);
+#elif defined(WIZ_SPAN_NEON)
+	const uint16x8_t colors = vdupq_n_u16(color);
+	for (; count >= 8; count -= 8, dst += 16)
+		vst1q_u8(dst, vreinterpretq_u8_u16(colors));
+#endif
+
+	for (; count > 0; --count, dst += 2)
+		WRITE_LE_UINT16(dst, color);
+}
+
+void wizSpanBlendFill16(uint8 *dst, uint16 color, int count) {
+#if defined(WIZ_SPAN_SSE2)
+	const __m128i mask = _mm_set1_epi16(0x7DEF);
+	const __m128i half = _mm_set1_epi16((short)((color >> 1) & 0x7DEF));
+	for (; count >= 8; count -= 8, dst += 16) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)dst);
+		_mm_storeu_si128((__m128i *)dst, _mm_add_epi16(half, _mm_and_si128(_mm_srli_epi16(pixels, 1), mask)));
+	}
+#elif defined(WIZ_SPAN_NEON)
+	const uint16x8_t mask = vdupq_n_u16(0x7DEF);
+	const uint16x8_t half = vdupq_n_u16((color >> 1) & 0x7DEF);
+	for (; count >= 8; count -= 8, dst += 16) {
+		const uint16x8_t pixels = vreinterpretq_u16_u8(vld1q_u8(dst));
+		vst1q_u8(dst, vreinterpretq_u8_u16(vaddq_u16(half, vandq_u16(vshrq_n_u16(pixels, 1), mask))));
+	}
+#endif
+
+	for (; count > 0; --count, dst += 2)
+		WRITE_LE_UINT16(dst, blend555(color, READ_LE_UINT16(dst)));
+}
+
+void wizSpanBlend16(uint8 *dst, const uint8 *src, int count) {
+#if defined(WIZ_SPAN_SSE2)
+	const __m128i mask = _mm_set1_epi16(0x7DEF);
+	for (; count >= 8; count -= 8, src += 16, dst += 16) {
+		const __m128i colors = _mm_loadu_si128((const __m128i *)src);
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)dst);
+		_mm_storeu_si128((__m128i *)dst, _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(colors, 1), mask),
+		                                               _mm_and_si128(_mm_srli_epi16(pixels, 1), mask)));
+	}
+#elif defined(WIZ_SPAN_NEON)
+	const uint16x8_t mask = vdupq_n_u16(0x7DEF);
+	for (; count >= 8; count -= 8, src += 16, dst += 16) {
+		const uint16x8_t colors = vreinterpretq_u16_u8(vld1q_u8(src));
+		const uint16x8_t pixels = vreinterpretq_u16_u8(vld1q_u8(dst));
+		vst1q_u8(dst, vreinterpretq_u8_u16(vaddq_u16(vandq_u16(vshrq_n_u16(colors, 1), mask),
+		                                             vandq_u16(vshrq_n_u16(pixels, 1), mask))));
+	}
+#endif
+
+	for (; count > 0; --count, src += 2, dst += 2)
+		WRITE_LE_UINT16(dst, blend555(READ_LE_UINT16(src), READ_LE_UINT16(dst)));
+}
+
+void wizSpanRemap8(uint8 *dst, const uint8 *src, const uint8 *palPtr, int count) {
+	for (int i = 0; i < count; ++i)
+		dst[i] = palPtr[src[i]];
+}
+
+void wizSpanXMapFill8(uint8 *dst, const uint8 *xmapRow, int count) {
+	for (int i = 0; i < count; ++i)
+		dst[i] = xmapRow[dst[i]];
+}
+
+void wizSpanXMap8(uint8 *dst, const uint8 *src, const uint8 *xmapPtr, int count) {
+	for (int i = 0; i < count; ++i)
+		dst[i] = xmapPtr[src[i] * 256 + dst[i]];
+}
+
+} // End of namespace Scumm
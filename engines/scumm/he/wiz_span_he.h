@@ -0,0 +1,64 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_HE_WIZ_SPAN_HE_H
+#define SCUMM_HE_WIZ_SPAN_HE_H
+
+#include "common/scummsys.h"
+
+namespace Scumm {
+
+/**
+ * @name Wiz span kernels
+ * Inner loops used by the Wiz decompressors to draw whole RLE runs and
+ * literal runs at once. Where available, the 16-bit kernels use SSE2 or
+ * NEON; all of them give exactly the same result as drawing the pixels one
+ * by one. 16-bit colors are little endian RGB555.
+ * @{
+ */
+
+/** Sets `count` 16-bit pixels to `color`. */
+void wizSpanFill16(uint8 *dst, uint16 color, int count);
+
+/** Mixes `color` 50/50 into `count` 16-bit pixels. */
+void wizSpanBlendFill16(uint8 *dst, uint16 color, int count);
+
+/** Mixes `count` 16-bit pixels from `src` 50/50 into `dst`. */
+void wizSpanBlend16(uint8 *dst, const uint8 *src, int count);
+
+/** Draws `count` 8-bit pixels from `src` through the palette map `palPtr`. */
+void wizSpanRemap8(uint8 *dst, const uint8 *src, const uint8 *palPtr, int count);
+
+/**
+ * Replaces `count` 8-bit pixels with their entries in `xmapRow`, the row
+ * of the 256x256 translucency map belonging to the source color of a run.
+ */
+void wizSpanXMapFill8(uint8 *dst, const uint8 *xmapRow, int count);
+
+/** Draws `count` 8-bit pixels from `src` through the translucency map. */
+void wizSpanXMap8(uint8 *dst, const uint8 *src, const uint8 *xmapPtr, int count);
+
+/** @} */
+
+} // End of namespace Scumm
+
+#endif
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/str.h"
 #ifndef MACOSX
 #include "common/config-manager.h"
@@ -44,8 +45,7 @@ namespace Scumm {
 
 enum {
 	RF_LOCK = 0x80,
-	RF_USAGE = 0x7F,
-	RF_USAGE_MAX = RF_USAGE,
+	RF_USAGE_MAX = 0x7F,
 
 	RS_MODIFIED = 0x10,
 	RF_OFFHEAP = 0x40
@@ -780,28 +780,20 @@ void ResourceManager::increaseExpireCounter() {
 }
 
 void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
-		}
-	}
+	// Counters are derived from the age clock, so this ages every resource
+	++_ageClock;
 }
 
 void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
-	_types[type][idx].setResourceCounter(counter);
-}
-
-void ResourceManager::Resource::setResourceCounter(byte counter) {
-	_flags &= RF_LOCK;	// Clear lower 7 bits, preserve the lock bit.
-	_flags |= counter;	// Update the usage counter
+	counter = MIN<byte>(counter, RF_USAGE_MAX);
+	_types[type][idx]._lastUsed = counter ? _ageClock - (counter - 1) : 0;
 }
 
-byte ResourceManager::Resource::getResourceCounter() const {
-	return _flags & RF_USAGE;
+byte ResourceManager::getResourceCounter(ResType type, ResId idx) const {
+	const uint32 lastUsed = _types[type][idx]._lastUsed;
+	if (!lastUsed)
+		return 0;
+	return MIN<uint32>(_ageClock - lastUsed + 1, RF_USAGE_MAX);
 }
 
 /* 2 bytes safety area to make "precaching" of bytes in the gdi drawer easier */
@@ -833,6 +825,8 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 
 	memset(ptr, 0, size + SAFETY_AREA);
 	_allocatedSize += size;
+	_stats[type].loads++;
+	_stats[type].loadedBytes += size;
 
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
@@ -844,6 +838,7 @@ ResourceManager::Resource::Resource() {
 	_address = 0;
 	_size = 0;
 	_flags = 0;
+	_lastUsed = 0;
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
@@ -859,6 +854,7 @@ void ResourceManager::Resource::nuke() {
 	_address = 0;
 	_size = 0;
 	_flags = 0;
+	_lastUsed = 0;
 	_status &= ~RS_MODIFIED;
 }
 
@@ -875,6 +871,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	// Start late enough for every counter to have a non-zero time stamp
+	_ageClock = RF_USAGE_MAX;
+	resetStatistics();
 }
 
 ResourceManager::~ResourceManager() {
@@ -1035,10 +1034,22 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+/**
+ * Orders expire candidates the way a linear scan for the highest counter
+ * would pick them: oldest first, then by descending type and ascending index.
+ */
+struct ExpireCandidateOlder {
+	template<class T>
+	bool operator()(const T &a, const T &b) const {
+		if (a.counter != b.counter)
+			return a.counter > b.counter;
+		if (a.type != b.type)
+			return a.type > b.type;
+		return a.idx < b.idx;
+	}
+};
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1050,32 +1061,43 @@ void ResourceManager::expireResources(uint32 size) {
 		return;
 
 	oldAllocatedSize = _allocatedSize;
+	_expireRuns++;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
+	// Collect everything which may be thrown out in a single pass, instead
+	// of rescanning all resources for each one we expire. Nuking a resource
+	// changes neither the counters nor the in use state of the others, so
+	// the sorted order is the one repeated scans would yield.
+	_expireCandidates.clear();
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		if (_types[type]._mode != kDynamicResTypeMode) {
+			// Resources of this type can be reloaded from the data files,
+			// so we can potentially unload them to free memory.
+			ResId idx = _types[type].size();
+			while (idx-- > 0) {
+				Resource &tmp = _types[type][idx];
+				if (!tmp._address || tmp.isLocked() || tmp.isOffHeap())
+					continue;
+				byte counter = getResourceCounter(type, idx);
+				if (counter >= 2 && !_vm->isResourceInUse(type, idx)) {
+					ExpireCandidate candidate;
+					candidate.type = type;
+					candidate.idx = idx;
+					candidate.counter = counter;
+					_expireCandidates.push_back(candidate);
 				}
 			}
 		}
-
-		if (!best_type)
+	}
+	Common::sort(_expireCandidates.begin(), _expireCandidates.end(), ExpireCandidateOlder());
+
+	for (uint i = 0; i < _expireCandidates.size(); ++i) {
+		const ExpireCandidate &candidate = _expireCandidates[i];
+		_stats[candidate.type].expirations++;
+		_stats[candidate.type].expiredBytes += _types[candidate.type][candidate.idx]._size;
+		nukeResource(candidate.type, candidate.idx);
+		if (size + _allocatedSize <= _minHeapThreshold)
 			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+	}
 
 	increaseResourceCounters();
 
@@ -1139,6 +1161,11 @@ void ResourceManager::resourceStats() {
 	debug(1, "Total allocated size=%d, locked=%d(%d)", _allocatedSize, lockedSize, lockedNum);
 }
 
+void ResourceManager::resetStatistics() {
+	memset(_stats, 0, sizeof(_stats));
+	_expireRuns = 0;
+}
+
 void ScummEngine_v5::readMAXS(int blockSize) {
 	_numVariables = _fileHandle->readUint16LE();      // 800
 	_fileHandle->readUint16LE();                      // 16
@@ -81,6 +81,7 @@ protected:
 
 public:
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -95,15 +96,24 @@ public:
 	protected:
 		/**
 		 * The uppermost bit indicates whether the resources is locked.
-		 * The lower 7 bits contain a counter. This counter measures roughly
-		 * how old the resource is; it starts out with a count of 1 and can go
-		 * as high as 127. When memory falls low resp. when the engine decides
-		 * that it should throw out some unused stuff, then it begins by
-		 * removing the resources with the highest counter (excluding locked
-		 * resources and resources that are known to be in use).
 		 */
 		byte _flags;
 
+		/**
+		 * Value of the resource manager's age clock when the usage counter
+		 * of this resource was last set to 1, or 0 if the counter is unset.
+		 * The counter measures roughly how old the resource is; it starts
+		 * out with a count of 1 and can go as high as 127. When memory falls
+		 * low resp. when the engine decides that it should throw out some
+		 * unused stuff, then it begins by removing the resources with the
+		 * highest counter (excluding locked resources and resources that are
+		 * known to be in use).
+		 *
+		 * Keeping a time stamp instead of the counter itself means aging all
+		 * resources only requires advancing the clock.
+		 */
+		uint32 _lastUsed;
+
 		/**
 		 * The status of the resource. Currently only one bit is used, which
 		 * indicates whether the resource is modified.
@@ -132,9 +142,6 @@ public:
 
 		void nuke();
 
-		inline void setResourceCounter(byte counter);
-		inline byte getResourceCounter() const;
-
 		void lock();
 		void unlock();
 		bool isLocked() const;
@@ -171,11 +178,40 @@ public:
 	};
 	ResTypeData _types[rtLast + 1];
 
+	/**
+	 * Allocation and expiration counts of a resource type, for debugging
+	 * the heap threshold.
+	 */
+	struct TypeStatistics {
+		uint32 loads;
+		uint32 loadedBytes;
+		uint32 expirations;
+		uint32 expiredBytes;
+	};
+
 protected:
+	/**
+	 * A resource which may be thrown out by expireResources.
+	 */
+	struct ExpireCandidate {
+		ResType type;
+		ResId idx;
+		byte counter;
+	};
+
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * Incremented whenever all resource counters are increased.
+	 */
+	uint32 _ageClock;
+
+	TypeStatistics _stats[rtLast + 1];
+	uint32 _expireRuns;
+	Common::Array<ExpireCandidate> _expireCandidates;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
@@ -216,8 +252,13 @@ public:
 	void setResourceCounter(ResType type, ResId idx, byte counter);
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
+	 * Return the specified resource's counter.
+	 */
+	byte getResourceCounter(ResType type, ResId idx) const;
+
+	/**
+	 * Increment the counter of all resources with a non-zero counter.
+	 * The maximal count is 127.
 	 * This is called by increaseExpireCounter and expireResources,
 	 * but also by ScummEngine::startScene.
 	 */
@@ -225,6 +266,13 @@ public:
 
 	void resourceStats();
 
+	const TypeStatistics &getTypeStatistics(ResType type) const { return _stats[type]; }
+	uint32 getExpireRuns() const { return _expireRuns; }
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+	uint32 getMinHeapThreshold() const { return _minHeapThreshold; }
+	void resetStatistics();
+
 //protected:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
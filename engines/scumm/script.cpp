@@ -21,6 +21,7 @@
  */
 
 #include "common/config-manager.h"
+#include "common/debug-channels.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -442,55 +443,66 @@ void ScummEngine::resetScriptPointer() {
 }
 
 /**
- * This method checks whether the resource that contains the active script
- * moved, and if so, updates the script pointer accordingly.
+ * Updates the script pointer after the resource that contains the active
+ * script moved.
  *
  * The script resource may have moved because it might have been garbage
  * collected by ResourceManager::expireResources.
  */
-void ScummEngine::refreshScriptPointer() {
-	if (*_lastCodePtr != _scriptOrgPointer) {
-		long oldoffs = _scriptPointer - _scriptOrgPointer;
-		getScriptBaseAddress();
-		_scriptPointer = _scriptOrgPointer + oldoffs;
-	}
+void ScummEngine::scriptResourceMoved() {
+	long oldoffs = _scriptPointer - _scriptOrgPointer;
+	getScriptBaseAddress();
+	_scriptPointer = _scriptOrgPointer + oldoffs;
 }
 
 /** Execute a script - Read opcode, and execute it from the table */
 void ScummEngine::executeScript() {
-	int c;
-	while (_currentScript != 0xFF) {
+	// Tracing can only be switched on and off from the debugger, which never
+	// runs in the middle of a script
+	const bool trace = _showStack || _hexdumpScripts || _profileOpcodes ||
+		DebugMan.isDebugChannelEnabled(DEBUG_OPCODES) || gDebugLevel >= 9;
 
-		if (_showStack == 1) {
-			debugN("Stack:");
-			for (c = 0; c < _scummStackPos; c++) {
-				debugN(" %d", _vmStack[c]);
-			}
-			debugN("\n");
-		}
+	while (_currentScript != 0xFF) {
 		_opcode = fetchScriptByte();
 		if (_game.version > 2) // V0-V2 games didn't use the didexec flag
 			vm.slot[_currentScript].didexec = true;
-		debugC(DEBUG_OPCODES, "Script %d, offset 0x%x: [%X] %s()",
-				vm.slot[_currentScript].number,
-				(uint)(_scriptPointer - _scriptOrgPointer),
-				_opcode,
-				getOpcodeDesc(_opcode));
-		if (_hexdumpScripts == true) {
-			for (c = -1; c < 15; c++) {
-				debugN(" %02x", *(_scriptPointer + c));
-			}
-			debugN("\n");
-		}
+		if (trace)
+			traceOpcode();
 
 		executeOpcode(_opcode);
+	}
+}
+
+/** Prints the debug output for, and counts, the opcode about to be executed */
+void ScummEngine::traceOpcode() {
+	int c;
 
+	if (_profileOpcodes)
+		_opcodeCounts[_opcode]++;
+
+	if (_showStack == 1) {
+		debugN("Stack:");
+		for (c = 0; c < _scummStackPos; c++) {
+			debugN(" %d", _vmStack[c]);
+		}
+		debugN("\n");
+	}
+	debugC(DEBUG_OPCODES, "Script %d, offset 0x%x: [%X] %s()",
+			vm.slot[_currentScript].number,
+			(uint)(_scriptPointer - _scriptOrgPointer),
+			_opcode,
+			getOpcodeDesc(_opcode));
+	if (_hexdumpScripts == true) {
+		for (c = -1; c < 15; c++) {
+			debugN(" %02x", *(_scriptPointer + c));
+		}
+		debugN("\n");
 	}
 }
 
 void ScummEngine::executeOpcode(byte i) {
-	if (_opcodes[i].proc && _opcodes[i].proc->isValid())
-		(*_opcodes[i].proc)();
+	if (_opcodes[i].proc)
+		(this->*_opcodes[i].proc)();
 	else {
 		error("Invalid opcode '%x' at %lx", i, (long)(_scriptPointer - _scriptOrgPointer));
 	}
@@ -504,11 +516,6 @@ const char *ScummEngine::getOpcodeDesc(byte i) {
 #endif
 }
 
-byte ScummEngine::fetchScriptByte() {
-	refreshScriptPointer();
-	return *_scriptPointer++;
-}
-
 uint ScummEngine::fetchScriptWord() {
 	refreshScriptPointer();
 	uint a = READ_LE_UINT16(_scriptPointer);
@@ -659,9 +659,17 @@ protected:
 
 	OpcodeEntry _opcodes[256];
 
+	/**
+	 * Execution counts per opcode, gathered while `_profileOpcodes` is set.
+	 * Shown by the `opcodes` debugger command.
+	 */
+	uint32 _opcodeCounts[256];
+	bool _profileOpcodes;
+
 	virtual void setupOpcodes() = 0;
 	void executeOpcode(byte i);
 	const char *getOpcodeDesc(byte i);
+	void traceOpcode();
 
 	void initializeLocals(int slot, int *vars);
 	int	getScriptSlot();
@@ -704,8 +712,19 @@ protected:
 	void resetScriptPointer();
 	int getVerbEntrypoint(int obj, int entry);
 
-	void refreshScriptPointer();
-	byte fetchScriptByte();
+	/**
+	 * Checks whether the resource that contains the active script moved, and
+	 * if so, updates the script pointer accordingly.
+	 */
+	inline void refreshScriptPointer() {
+		if (*_lastCodePtr != _scriptOrgPointer)
+			scriptResourceMoved();
+	}
+	void scriptResourceMoved();
+	inline byte fetchScriptByte() {
+		refreshScriptPointer();
+		return *_scriptPointer++;
+	}
 	virtual uint fetchScriptWord();
 	virtual int fetchScriptWordSigned();
 	uint fetchScriptDWord();
@@ -37,8 +37,10 @@ void Screen::update() {
 	if (_cursor) {
 		// Check whether the area the cursor occupies will be being updated
 		Common::Rect cursorBounds = _cursor->getBounds();
-		for (Common::List<Common::Rect>::iterator i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
-			const Common::Rect &r = *i;
+		Common::Array<Common::Rect> dirtyRects;
+		getDirtyRects(dirtyRects);
+		for (uint i = 0; i < dirtyRects.size(); ++i) {
+			const Common::Rect &r = dirtyRects[i];
 			if (r.intersects(cursorBounds)) {
 				addDirtyRect(cursorBounds);
 				_drawCursor = true;
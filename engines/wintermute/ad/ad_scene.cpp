@@ -90,6 +90,8 @@ void AdScene::setDefaults() {
 	_mainLayer = nullptr;
 
 	_pfPointsNum = 0;
+	_pfCacheWidth = _pfCacheHeight = 0;
+	_pfCacheSignature = 0;
 	_persistentState = false;
 	_persistentStateSprites = true;
 
@@ -175,6 +177,8 @@ void AdScene::cleanup() {
 	}
 	_pfPath.clear();
 	_pfPointsNum = 0;
+	_pfBlockRegions.clear();
+	_pfBlockedCache.clear();
 
 	for (uint32 i = 0; i < _objects.size(); i++) {
 		_gameRef->unregisterObject(_objects[i]);
@@ -334,8 +338,6 @@ uint32 AdScene::getAlphaAt(int x, int y, bool colorCheck) {
 
 //////////////////////////////////////////////////////////////////////////
 bool AdScene::isBlockedAt(int x, int y, bool checkFreeObjects, BaseObject *requester) {
-	bool ret = true;
-
 	if (checkFreeObjects) {
 		for (uint32 i = 0; i < _objects.size(); i++) {
 			if (_objects[i]->_active && _objects[i] != requester && _objects[i]->_currentBlockRegion) {
@@ -354,6 +356,13 @@ bool AdScene::isBlockedAt(int x, int y, bool checkFreeObjects, BaseObject *reque
 		}
 	}
 
+	return isRegionBlockedAt(x, y);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdScene::isRegionBlockedAt(int x, int y) {
+	bool ret = true;
 
 	if (_mainLayer) {
 		for (uint32 i = 0; i < _mainLayer->_nodes.size(); i++) {
@@ -379,6 +388,95 @@ bool AdScene::isBlockedAt(int x, int y, bool checkFreeObjects, BaseObject *reque
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+uint32 AdScene::getRegionsSignature() {
+	// FNV-1a over everything isRegionBlockedAt() depends on
+	uint32 hash = 2166136261u;
+#define PF_HASH(value) hash = (hash ^ (uint32)(value)) * 16777619u
+
+	if (_mainLayer) {
+		PF_HASH(_mainLayer->_width);
+		PF_HASH(_mainLayer->_height);
+		for (uint32 i = 0; i < _mainLayer->_nodes.size(); i++) {
+			AdSceneNode *node = _mainLayer->_nodes[i];
+			if (node->_type != OBJECT_REGION) {
+				continue;
+			}
+			AdRegion *region = node->_region;
+			PF_HASH(i);
+			PF_HASH(region->_active | (region->hasDecoration() << 1) | (region->isBlocked() << 2));
+			for (uint32 j = 0; j < region->_points.size(); j++) {
+				PF_HASH(region->_points[j]->x);
+				PF_HASH(region->_points[j]->y);
+			}
+		}
+	}
+
+#undef PF_HASH
+	return hash;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfPrepareBlocking() {
+	// The free objects may have moved since the last frame
+	_pfBlockRegions.clear();
+	for (uint32 i = 0; i < _objects.size(); i++) {
+		if (_objects[i]->_active && _objects[i] != _pfRequester && _objects[i]->_currentBlockRegion) {
+			_pfBlockRegions.push_back(_objects[i]->_currentBlockRegion);
+		}
+	}
+	AdGame *adGame = (AdGame *)_gameRef;
+	for (uint32 i = 0; i < adGame->_objects.size(); i++) {
+		if (adGame->_objects[i]->_active && adGame->_objects[i] != _pfRequester && adGame->_objects[i]->_currentBlockRegion) {
+			_pfBlockRegions.push_back(adGame->_objects[i]->_currentBlockRegion);
+		}
+	}
+
+	// Scripts may have changed the regions, too
+	const uint32 signature = getRegionsSignature();
+	if (!_mainLayer) {
+		_pfCacheWidth = _pfCacheHeight = 0;
+		_pfBlockedCache.clear();
+	} else if (signature != _pfCacheSignature || _pfCacheWidth != _mainLayer->_width || _pfCacheHeight != _mainLayer->_height) {
+		_pfCacheWidth = MAX<int32>(_mainLayer->_width, 0);
+		_pfCacheHeight = MAX<int32>(_mainLayer->_height, 0);
+		_pfBlockedCache.clear();
+		_pfBlockedCache.resize((_pfCacheWidth * _pfCacheHeight + 3) / 4);
+		Common::fill(_pfBlockedCache.begin(), _pfBlockedCache.end(), 0);
+	}
+	_pfCacheSignature = signature;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdScene::pfIsBlockedAt(int x, int y) {
+	// Same as isBlockedAt(x, y, true, _pfRequester), as of the last call of
+	// pfPrepareBlocking()
+	for (uint32 i = 0; i < _pfBlockRegions.size(); i++) {
+		if (_pfBlockRegions[i]->pointInRegion(x, y)) {
+			return true;
+		}
+	}
+
+	if (x < 0 || y < 0 || x >= _pfCacheWidth || y >= _pfCacheHeight) {
+		return isRegionBlockedAt(x, y);
+	}
+
+	const uint32 pos = y * _pfCacheWidth + x;
+	byte &cell = _pfBlockedCache[pos >> 2];
+	const int shift = (pos & 3) * 2;
+	const byte state = (cell >> shift) & 3;
+	if (state) {
+		return state == 2;
+	}
+
+	const bool blocked = isRegionBlockedAt(x, y);
+	cell |= (blocked ? 2 : 1) << shift;
+	return blocked;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool AdScene::isWalkableAt(int x, int y, bool checkFreeObjects, BaseObject *requester) {
 	bool ret = false;
@@ -433,6 +531,9 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 	xLength = abs(x2 - x1);
 	yLength = abs(y2 - y1);
 
+	// The path finder knows which objects block its requester
+	const bool cached = !_pfReady && requester == _pfRequester;
+
 	if (xLength > yLength) {
 		if (x1 > x2) {
 			BaseUtils::swap(&x1, &x2);
@@ -443,7 +544,7 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 		y = y1;
 
 		for (xCount = x1; xCount < x2; xCount++) {
-			if (isBlockedAt(xCount, (int)y, true, requester)) {
+			if (cached ? pfIsBlockedAt(xCount, (int)y) : isBlockedAt(xCount, (int)y, true, requester)) {
 				return -1;
 			}
 			y += yStep;
@@ -458,7 +559,7 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 		x = x1;
 
 		for (yCount = y1; yCount < y2; yCount++) {
-			if (isBlockedAt((int)x, yCount, true, requester)) {
+			if (cached ? pfIsBlockedAt((int)x, yCount) : isBlockedAt((int)x, yCount, true, requester)) {
 				return -1;
 			}
 			x += xStep;
@@ -502,14 +603,34 @@ void AdScene::pathFinderStep() {
 	}
 
 	// otherwise keep on searching
-	for (i = 0; i < _pfPointsNum; i++)
-		if (!_pfPath[i]->_marked) {
-			int j = getPointsDist(*lowestPt, *_pfPath[i], _pfRequester);
-			if (j != -1 && lowestPt->_distance + j < _pfPath[i]->_distance) {
-				_pfPath[i]->_distance = lowestPt->_distance + j;
-				_pfPath[i]->_origin = lowestPt;
-			}
+	//
+	// getPointsDist() returns the larger of the coordinate differences, if
+	// the points can see each other. So the line between them only needs to
+	// be walked if that would shorten the path to the point, and a path via
+	// the point could still lead to the target (point 1) faster than the
+	// one known so far. The distance estimate can't be larger than the
+	// actual one, so this finds the same paths as checking every point.
+	const int targetDist = _pfPath[1]->_distance;
+	for (i = 0; i < _pfPointsNum; i++) {
+		AdPathPoint *pt = _pfPath[i];
+		if (pt->_marked) {
+			continue;
+		}
+
+		const int estimate = lowestPt->_distance + MAX(ABS(pt->x - lowestPt->x), ABS(pt->y - lowestPt->y));
+		if (estimate >= pt->_distance) {
+			continue;
 		}
+		if (targetDist != INT_MAX && estimate + MAX(ABS(_pfTarget->x - pt->x), ABS(_pfTarget->y - pt->y)) > targetDist) {
+			continue;
+		}
+
+		int j = getPointsDist(*lowestPt, *pt, _pfRequester);
+		if (j != -1 && lowestPt->_distance + j < pt->_distance) {
+			pt->_distance = lowestPt->_distance + j;
+			pt->_origin = lowestPt;
+		}
+	}
 }
 
 
@@ -527,6 +648,9 @@ bool AdScene::initLoop() {
 	}
 #else
 	uint32 start = _gameRef->_currentTime;
+	if (!_pfReady) {
+		pfPrepareBlocking();
+	}
 	while (!_pfReady && g_system->getMillis() - start <= _pfMaxTime) {
 		pathFinderStep();
 	}
@@ -30,6 +30,7 @@
 #define WINTERMUTE_ADSCENE_H
 
 #include "engines/wintermute/base/base_fader.h"
+#include "common/array.h"
 
 namespace Wintermute {
 
@@ -44,6 +45,7 @@ class AdPath;
 class AdScaleLevel;
 class AdRotLevel;
 class AdPathPoint;
+class BaseRegion;
 class AdScene : public BaseObject {
 public:
 
@@ -165,12 +167,26 @@ public:
 private:
 	bool persistState(bool saving = true);
 	void pfAddWaypointGroup(AdWaypointGroup *Wpt, BaseObject *requester = nullptr);
+	bool isRegionBlockedAt(int x, int y);
+	uint32 getRegionsSignature();
+	void pfPrepareBlocking();
+	bool pfIsBlockedAt(int x, int y);
 	bool _pfReady;
 	BasePoint *_pfTarget;
 	AdPath *_pfTargetPath;
 	BaseObject *_pfRequester;
 	BaseArray<AdPathPoint *> _pfPath;
 
+	// Block regions of the free objects the path finder has to avoid
+	Common::Array<BaseRegion *> _pfBlockRegions;
+	// Results of isRegionBlockedAt(), two bits per pixel of the main layer:
+	// 0 - not known yet, 1 - walkable, 2 - blocked. Valid as long as the
+	// regions match _pfCacheSignature.
+	Common::Array<byte> _pfBlockedCache;
+	int32 _pfCacheWidth;
+	int32 _pfCacheHeight;
+	uint32 _pfCacheSignature;
+
 	int32 _offsetTop;
 	int32 _offsetLeft;
 
@@ -33,6 +33,7 @@
 #include "common/singleton.h"
 #include "common/random.h"
 #include "common/language.h"
+#include "engines/wintermute/base/scriptables/script_atoms.h"
 
 namespace Wintermute {
 
@@ -110,6 +111,7 @@ class BaseEngine : public Common::Singleton<Wintermute::BaseEngine> {
 	// We need random numbers
 	Common::RandomSource *_rnd;
 	SystemClassRegistry *_classReg;
+	ScAtomTable _atoms;
 	Common::Language _language;
 	WMETargetExecutable _targetExecutable;
 	uint32 _flags;
@@ -124,6 +126,7 @@ public:
 	uint32 randInt(int from, int to);
 
 	SystemClassRegistry *getClassRegistry() { return _classReg; }
+	ScAtomTable &getAtoms() { return _atoms; }
 	BaseGame *getGameRef() { return _gameRef; }
 	BaseFileManager *getFileManager() { return _fileManager; }
 	BaseSoundMgr *getSoundMgr();
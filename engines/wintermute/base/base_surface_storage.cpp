@@ -60,6 +60,7 @@ bool BaseSurfaceStorage::cleanup(bool warn) {
 		delete _surfaces[i];
 	}
 	_surfaces.clear();
+	_surfaceMap.clear();
 
 	return STATUS_OK;
 }
@@ -67,18 +68,59 @@ bool BaseSurfaceStorage::cleanup(bool warn) {
 
 //////////////////////////////////////////////////////////////////////////
 bool BaseSurfaceStorage::initLoop() {
-	if (_gameRef->_smartCache && _gameRef->getLiveTimer()->getTime() - _lastCleanupTime >= _gameRef->_surfaceGCCycleTime) {
+	if (_gameRef->getLiveTimer()->getTime() - _lastCleanupTime >= _gameRef->_surfaceGCCycleTime) {
 		_lastCleanupTime = _gameRef->getLiveTimer()->getTime();
-		sortSurfaces();
-		for (uint32 i = 0; i < _surfaces.size(); i++) {
-			if (_surfaces[i]->_lifeTime <= 0) {
-				break;
+		if (_gameRef->_smartCache) {
+			sortSurfaces();
+			for (uint32 i = 0; i < _surfaces.size(); i++) {
+				if (_surfaces[i]->_lifeTime <= 0) {
+					break;
+				}
+
+				if (_surfaces[i]->_lifeTime > 0 && _surfaces[i]->_valid && (int)(_gameRef->getLiveTimer()->getTime() - _surfaces[i]->_lastUsedTime) >= _surfaces[i]->_lifeTime) {
+					//_gameRef->QuickMessageForm("Invalidating: %s", _surfaces[i]->_filename);
+					_surfaces[i]->invalidate();
+				}
 			}
+		}
+		// The cap on the decoded size applies with or without the smart cache
+		releaseDecodedSurfaces();
+	}
+	return STATUS_OK;
+}
 
-			if (_surfaces[i]->_lifeTime > 0 && _surfaces[i]->_valid && (int)(_gameRef->getLiveTimer()->getTime() - _surfaces[i]->_lastUsedTime) >= _surfaces[i]->_lifeTime) {
-				//_gameRef->QuickMessageForm("Invalidating: %s", _surfaces[i]->_filename);
-				_surfaces[i]->invalidate();
-			}
+
+//////////////////////////////////////////////////////////////////////////
+static bool surfaceUseCB(const BaseSurface *s1, const BaseSurface *s2) {
+	return s1->_lastUsedTime < s2->_lastUsedTime;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool BaseSurfaceStorage::releaseDecodedSurfaces() {
+	uint32 decodedSize = 0;
+	for (uint32 i = 0; i < _surfaces.size(); i++) {
+		decodedSize += _surfaces[i]->getDecodedSize();
+	}
+	if (decodedSize <= MAX_DECODED_SURFACE_SIZE) {
+		return STATUS_OK;
+	}
+
+	// Drop the pixels of the least recently drawn surfaces; they get
+	// decoded again from their file when they are needed the next time.
+	// Anything drawn in the current frame stays.
+	const uint32 now = _gameRef->getLiveTimer()->getTime();
+	Common::Array<BaseSurface *> candidates;
+	for (uint32 i = 0; i < _surfaces.size(); i++) {
+		if (_surfaces[i]->getDecodedSize() && _surfaces[i]->_lastUsedTime < now) {
+			candidates.push_back(_surfaces[i]);
+		}
+	}
+	Common::sort(candidates.begin(), candidates.end(), surfaceUseCB);
+
+	for (uint32 i = 0; i < candidates.size() && decodedSize > MAX_DECODED_SURFACE_SIZE; i++) {
+		const uint32 size = candidates[i]->getDecodedSize();
+		if (DID_SUCCEED(candidates[i]->invalidate())) {
+			decodedSize -= size;
 		}
 	}
 	return STATUS_OK;
@@ -91,6 +133,10 @@ bool BaseSurfaceStorage::removeSurface(BaseSurface *surface) {
 		if (_surfaces[i] == surface) {
 			_surfaces[i]->_referenceCount--;
 			if (_surfaces[i]->_referenceCount <= 0) {
+				SurfaceMap::iterator it = _surfaceMap.find(_surfaces[i]->getFileNameStr());
+				if (it != _surfaceMap.end() && it->_value == _surfaces[i]) {
+					_surfaceMap.erase(it);
+				}
 				delete _surfaces[i];
 				_surfaces.remove_at(i);
 			}
@@ -103,11 +149,10 @@ bool BaseSurfaceStorage::removeSurface(BaseSurface *surface) {
 
 //////////////////////////////////////////////////////////////////////
 BaseSurface *BaseSurfaceStorage::addSurface(const Common::String &filename, bool defaultCK, byte ckRed, byte ckGreen, byte ckBlue, int lifeTime, bool keepLoaded) {
-	for (uint32 i = 0; i < _surfaces.size(); i++) {
-		if (scumm_stricmp(_surfaces[i]->getFileName(), filename.c_str()) == 0) {
-			_surfaces[i]->_referenceCount++;
-			return _surfaces[i];
-		}
+	SurfaceMap::iterator it = _surfaceMap.find(filename);
+	if (it != _surfaceMap.end()) {
+		it->_value->_referenceCount++;
+		return it->_value;
 	}
 
 	if (!BaseFileManager::getEngineInstance()->hasFile(filename)) {
@@ -134,6 +179,7 @@ BaseSurface *BaseSurfaceStorage::addSurface(const Common::String &filename, bool
 	} else {
 		surface->_referenceCount = 1;
 		_surfaces.push_back(surface);
+		_surfaceMap[filename] = surface;
 		return surface;
 	}
 }
@@ -31,8 +31,14 @@
 
 #include "engines/wintermute/base/base.h"
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 
 namespace Wintermute {
+
+// Upper limit for the decoded pixel data of all stored surfaces, in bytes
+#define MAX_DECODED_SURFACE_SIZE (256 * 1024 * 1024)
+
 class BaseSurface;
 class BaseSurfaceStorage : public BaseClass {
 public:
@@ -41,6 +47,7 @@ public:
 	bool sortSurfaces();
 	static bool surfaceSortCB(const BaseSurface *arg1, const BaseSurface *arg2);
 	bool cleanup(bool warn = false);
+	bool releaseDecodedSurfaces();
 	//DECLARE_PERSISTENT(BaseSurfaceStorage, BaseClass);
 
 	bool restoreAll();
@@ -50,6 +57,9 @@ public:
 	~BaseSurfaceStorage() override;
 
 	Common::Array<BaseSurface *> _surfaces;
+private:
+	typedef Common::HashMap<Common::String, BaseSurface *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SurfaceMap;
+	SurfaceMap _surfaceMap;
 };
 
 } // End of namespace Wintermute
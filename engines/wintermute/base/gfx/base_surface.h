@@ -40,6 +40,10 @@ class BaseSurface: public BaseClass {
 public:
 	virtual bool invalidate();
 	virtual bool prepareToDraw();
+	// Size of the pixel data which invalidate() would release
+	virtual uint32 getDecodedSize() const {
+		return 0;
+	}
 	uint32 _lastUsedTime;
 	bool _valid;
 	int32 _lifeTime;
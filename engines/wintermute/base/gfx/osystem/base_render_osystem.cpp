@@ -34,6 +34,7 @@
 #include "engines/wintermute/math/math_util.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_sprite.h"
+#include "engines/wintermute/base/font/base_font.h"
 #include "common/system.h"
 #include "graphics/transparent_surface.h"
 #include "common/queue.h"
@@ -57,13 +58,14 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
 	}
 
 	_lastScreenChangeID = g_system->getScreenChangeID();
+	memset(&_frameStats, 0, sizeof(_frameStats));
+	memset(&_lastFrameStats, 0, sizeof(_lastFrameStats));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -74,8 +76,7 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		it = _renderQueue.erase(it);
 		delete ticket;
 	}
-
-	delete _dirtyRect;
+	_ticketIndex.clear();
 
 	_renderSurface->free();
 	delete _renderSurface;
@@ -137,6 +138,7 @@ bool BaseRenderOSystem::initRenderer(int width, int height, bool windowed) {
 
 	_renderSurface->create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 	_blankSurface->create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
+	_dirtyRegion.setSize(_renderSurface->w, _renderSurface->h);
 	_blankSurface->fillRect(Common::Rect(0, 0, _blankSurface->h, _blankSurface->w), _blankSurface->format.ARGBToColor(255, 0, 0, 0));
 	_active = true;
 
@@ -162,8 +164,7 @@ bool BaseRenderOSystem::forcedFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRegion.clear();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -173,6 +174,7 @@ bool BaseRenderOSystem::flip() {
 		for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
 			(*it)->_wantsDraw = false;
 		}
+		indexTickets();
 
 		addDirtyRect(_renderRect);
 		return true;
@@ -192,6 +194,7 @@ bool BaseRenderOSystem::flip() {
 				++it;
 			}
 		}
+		_ticketIndex.clear();
 	}
 
 	int oldScreenChangeID = _lastScreenChangeID;
@@ -202,9 +205,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRegion.clear();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -306,22 +307,11 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 
 	if (owner) { // Fade-tickets are owner-less
 		RenderTicket compare(owner, nullptr, srcRect, dstRect, transform);
-		RenderQueueIterator it = _lastFrameIter;
-		++it;
-		// Avoid calling end() and operator* every time, when potentially going through
-		// LOTS of tickets.
-		RenderQueueIterator endIterator = _renderQueue.end();
-		RenderTicket *compareTicket = nullptr;
-		for (; it != endIterator; ++it) {
-			compareTicket = *it;
-			if (*(compareTicket) == compare && compareTicket->_isValid) {
-				if (_disableDirtyRects) {
-					drawFromSurface(compareTicket);
-				} else {
-					drawFromQueuedTicket(it);
-				}
-				return;
-			}
+		RenderTicket *compareTicket = findReusableTicket(compare);
+		if (compareTicket) {
+			_frameStats.reused++;
+			drawFromQueuedTicket(compareTicket->_queuePos);
+			return;
 		}
 	}
 	RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
@@ -386,12 +376,9 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
-	}
-	_dirtyRect->clip(_renderRect);
+	Common::Rect dirtyRect(rect);
+	dirtyRect.clip(_renderRect);
+	_dirtyRegion.addRect(dirtyRect);
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -410,39 +397,81 @@ void BaseRenderOSystem::drawTickets() {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
-		it = _renderQueue.begin();
-		while (it != _renderQueue.end()) {
-			RenderTicket *ticket = *it;
-			ticket->_wantsDraw = false;
-			++it;
+
+	_dirtyRects.clear();
+	_dirtyRegion.getRects(_dirtyRects);
+
+	_drawList.clear();
+	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		(*it)->_wantsDraw = false;
+		_drawList.push_back(*it);
+	}
+	_frameStats.tickets = _drawList.size();
+	_frameStats.dirtyRects = 0;
+
+	if (!_dirtyRects.empty()) {
+		// Find the tickets which a later opaque ticket covers completely.
+		// Whatever they draw gets overwritten anyway.
+		const Common::Rect screen(_renderSurface->w, _renderSurface->h);
+		_occluded.resize(_drawList.size());
+		_opaqueTickets.clear();
+		for (uint i = _drawList.size(); i-- > 0;) {
+			const RenderTicket *ticket = _drawList[i];
+			Common::Rect area(ticket->_dstRect);
+			area.clip(screen);
+
+			_occluded[i] = false;
+			for (uint j = 0; j < _opaqueTickets.size(); j++) {
+				if (_drawList[_opaqueTickets[j]]->_dstRect.contains(area)) {
+					_occluded[i] = true;
+					break;
+				}
+			}
+			if (!_occluded[i] && ticket->isOpaque()) {
+				_opaqueTickets.push_back(i);
+			}
 		}
-		return;
 	}
 
-	it = _renderQueue.begin();
-	_lastFrameIter = _renderQueue.end();
-	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
-	// the background color. Typical use-case: Fullscreen FMVs.
-	// Caveat: The FPS-counter will invalidate this.
-	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
-		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
+	for (uint r = 0; r < _dirtyRects.size(); r++) {
+		Common::Rect dirtyRect(_dirtyRects[r]);
+		dirtyRect.clip(_renderRect);
+		if (dirtyRect.isEmpty()) {
+			continue;
+		}
+		_frameStats.dirtyRects++;
+
+		// Nothing below the topmost opaque ticket covering all of the dirty
+		// rect is visible, not even the clear-color. Typical use-cases:
+		// Fullscreen FMVs and backgrounds.
+		uint first = 0;
+		bool covered = false;
+		for (uint j = 0; j < _opaqueTickets.size(); j++) {
+			if (_drawList[_opaqueTickets[j]]->_dstRect.contains(dirtyRect)) {
+				first = _opaqueTickets[j];
+				covered = true;
+				break;
+			}
+		}
+		if (!covered) {
 			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+			_renderSurface->fillRect(dirtyRect, _clearColor);
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
-	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
+
+		for (uint i = 0; i < _drawList.size(); i++) {
+			RenderTicket *ticket = _drawList[i];
+			if (!ticket->_dstRect.intersects(dirtyRect)) {
+				continue;
+			}
+			if (i < first || _occluded[i]) {
+				_frameStats.occluded++;
+				continue;
+			}
+
 			// dstClip is the area we want redrawn.
 			Common::Rect dstClip(ticket->_dstRect);
 			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
+			dstClip.clip(dirtyRect);
 			// we need to keep track of the position to redraw the dirty rect
 			Common::Rect pos(dstClip);
 			int16 offsetX = ticket->_dstRect.left;
@@ -451,12 +480,15 @@ void BaseRenderOSystem::drawTickets() {
 			dstClip.translate(-offsetX, -offsetY);
 
 			drawFromSurface(ticket, &pos, &dstClip);
+			_frameStats.drawn++;
 			_needsFlip = true;
 		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
-		ticket->_wantsDraw = false;
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(dirtyRect.left, dirtyRect.top), _renderSurface->pitch, dirtyRect.left, dirtyRect.top, dirtyRect.width(), dirtyRect.height());
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+
+	_lastFrameIter = _renderQueue.end();
+	_lastFrameStats = _frameStats;
+	memset(&_frameStats, 0, sizeof(_frameStats));
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
@@ -471,6 +503,51 @@ void BaseRenderOSystem::drawTickets() {
 		}
 	}
 
+	indexTickets();
+}
+
+void BaseRenderOSystem::indexTickets() {
+	_ticketIndex.clear();
+	// Walk the queue backwards, so that every chain ends up in queue order
+	RenderQueueIterator it = _renderQueue.end();
+	while (it != _renderQueue.begin()) {
+		--it;
+		RenderTicket *ticket = *it;
+		ticket->_queuePos = it;
+		TicketIndex::iterator bucket = _ticketIndex.find(ticket->_hash);
+		if (bucket != _ticketIndex.end()) {
+			ticket->_nextWithHash = bucket->_value;
+			bucket->_value = ticket;
+		} else {
+			ticket->_nextWithHash = nullptr;
+			_ticketIndex[ticket->_hash] = ticket;
+		}
+	}
+}
+
+RenderTicket *BaseRenderOSystem::findReusableTicket(const RenderTicket &compare) const {
+	TicketIndex::const_iterator bucket = _ticketIndex.find(compare._hash);
+	if (bucket == _ticketIndex.end()) {
+		return nullptr;
+	}
+	// Tickets which were already reused this frame want to be drawn; new
+	// tickets are not indexed at all. The queue position is only valid for
+	// the others, as reusing a ticket may move it.
+	for (RenderTicket *ticket = bucket->_value; ticket; ticket = ticket->_nextWithHash) {
+		if (!ticket->_wantsDraw && ticket->_isValid && *ticket == compare) {
+			return ticket;
+		}
+	}
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool BaseRenderOSystem::displayDebugInfo() {
+	const FrameStatistics &stats = _lastFrameStats;
+	char str[100];
+	sprintf(str, "Tickets: %d (%d reused), drawn: %d, occluded: %d, dirty rects: %d", stats.tickets, stats.reused, stats.drawn, stats.occluded, stats.dirtyRects);
+	_gameRef->getSystemFont()->drawText((byte *)str, 0, 50, getWidth(), TAL_RIGHT);
+	return STATUS_OK;
 }
 
 // Replacement for SDL2's SDL_RenderCopy
@@ -592,6 +669,7 @@ void BaseRenderOSystem::endSaveLoad() {
 		it = _renderQueue.erase(it);
 		delete ticket;
 	}
+	_ticketIndex.clear();
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
 	_skipThisFrame = true;
@@ -31,7 +31,9 @@
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
 #include "common/rect.h"
+#include "graphics/dirty_region.h"
 #include "graphics/surface.h"
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "graphics/transform_struct.h"
 
@@ -53,6 +55,12 @@ class RenderTicket;
  * being equal, this information is then used to check whether the draw order changed,
  * which will then create a need for redrawing, as we draw with an alpha-channel here.
  *
+ * The tickets of last frame are indexed by a hash of their draw parameters,
+ * so looking up the match for an incoming ticket doesn't require walking the
+ * queue. The changed areas of the screen are collected in a tile based dirty
+ * region, and only the tickets intersecting one of its rects get redrawn,
+ * skipping those which a later opaque ticket covers completely.
+ *
  * There is also a draw path that draws without tickets, for debugging purposes,
  * as well as to accomodate situations with large enough amounts of draw calls,
  * that there will be too much overhead involved with comparing the generated tickets.
@@ -64,6 +72,18 @@ public:
 
 	typedef Common::List<RenderTicket *>::iterator RenderQueueIterator;
 
+	/**
+	 * Counters of the last frame drawn from tickets. Tickets are counted
+	 * once for every dirty rect they intersect.
+	 */
+	struct FrameStatistics {
+		uint32 tickets;		///< tickets in the render queue
+		uint32 reused;		///< tickets matched with one from the frame before
+		uint32 dirtyRects;	///< rects redrawn
+		uint32 drawn;		///< tickets drawn into a dirty rect
+		uint32 occluded;	///< tickets skipped, as opaque tickets cover them
+	};
+
 	Common::String getName() const override;
 
 	bool initRenderer(int width, int height, bool windowed) override;
@@ -103,6 +123,8 @@ public:
 	void pointToScreen(Point32 *point);
 
 	void dumpData(const char *filename) override;
+	bool displayDebugInfo() override;
+	const FrameStatistics &getFrameStatistics() const { return _lastFrameStats; }
 
 	float getScaleRatioX() const override {
 		return _ratioX;
@@ -125,13 +147,33 @@ private:
 	 * Traverse the tickets that are dirty, and draw them
 	 */
 	void drawTickets();
+	/**
+	 * Rebuild the hash index of the tickets in the render queue
+	 */
+	void indexTickets();
+	/**
+	 * Find the first ticket from last frame which is still unused and
+	 * matches the draw parameters of the given one
+	 */
+	RenderTicket *findReusableTicket(const RenderTicket &compare) const;
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	Graphics::DirtyRegion _dirtyRegion;
+	Common::Array<Common::Rect> _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
 
+	typedef Common::HashMap<uint32, RenderTicket *> TicketIndex;
+	TicketIndex _ticketIndex;
+	// The render queue in an array, and for each entry whether it is occluded
+	Common::Array<RenderTicket *> _drawList;
+	Common::Array<bool> _occluded;
+	// Indices into _drawList of the opaque tickets, topmost first
+	Common::Array<uint> _opaqueTickets;
+	FrameStatistics _frameStats;
+	FrameStatistics _lastFrameStats;
+
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
 	Common::Rect _renderRect;
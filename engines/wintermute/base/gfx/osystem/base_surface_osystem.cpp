@@ -50,6 +50,7 @@ BaseSurfaceOSystem::BaseSurfaceOSystem(BaseGame *inGame) : BaseSurface(inGame) {
 	_lockPixels = nullptr;
 	_lockPitch = 0;
 	_loaded = false;
+	_modified = false;
 	_rotation = 0;
 }
 
@@ -64,7 +65,9 @@ BaseSurfaceOSystem::~BaseSurfaceOSystem() {
 	delete[] _alphaMask;
 	_alphaMask = nullptr;
 
-	_gameRef->addMem(-_width * _height * 4);
+	if (_valid) {
+		_gameRef->addMem(-_width * _height * 4);
+	}
 	BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(_gameRef->_renderer);
 	renderer->invalidateTicketsFromSurface(this);
 }
@@ -131,6 +134,29 @@ bool BaseSurfaceOSystem::create(const Common::String &filename, bool defaultCK,
 	return STATUS_OK;
 }
 
+//////////////////////////////////////////////////////////////////////////
+bool BaseSurfaceOSystem::invalidate() {
+	// Only pixels which came from a file, unchanged, can be decoded again
+	if (!getDecodedSize()) {
+		return STATUS_FAILED;
+	}
+
+	_surface->free();
+	_gameRef->addMem(-_width * _height * 4);
+	_loaded = false;
+	_valid = false;
+
+	return STATUS_OK;
+}
+
+//////////////////////////////////////////////////////////////////////////
+uint32 BaseSurfaceOSystem::getDecodedSize() const {
+	if (!_loaded || !_valid || _keepLoaded || _modified || _filename.empty()) {
+		return 0;
+	}
+	return _surface->pitch * _surface->h;
+}
+
 bool BaseSurfaceOSystem::finishLoad() {
 	BaseImage *image = new BaseImage();
 	if (!image->loadFile(_filename)) {
@@ -312,6 +338,10 @@ bool BaseSurfaceOSystem::isTransparentAt(int x, int y) {
 
 //////////////////////////////////////////////////////////////////////////
 bool BaseSurfaceOSystem::isTransparentAtLite(int x, int y) {
+	if (!_loaded) {
+		finishLoad();
+	}
+
 	if (x < 0 || x >= _surface->w || y < 0 || y >= _surface->h) {
 		return true;
 	}
@@ -411,6 +441,7 @@ bool BaseSurfaceOSystem::drawSprite(int x, int y, Rect32 *rect, Rect32 *newRect,
 	if (!_loaded) {
 		finishLoad();
 	}
+	_lastUsedTime = _gameRef->getLiveTimer()->getTime();
 
 	if (renderer->_forceAlphaColor != 0) {
 		transform._rgbaMod = renderer->_forceAlphaColor;
@@ -463,6 +494,8 @@ bool BaseSurfaceOSystem::drawSprite(int x, int y, Rect32 *rect, Rect32 *newRect,
 
 bool BaseSurfaceOSystem::putSurface(const Graphics::Surface &surface, bool hasAlpha) {
 	_loaded = true;
+	// The file doesn't hold these pixels, so they must never be released
+	_modified = true;
 	if (surface.format == _surface->format && surface.pitch == _surface->pitch && surface.h == _surface->h) {
 		const byte *src = (const byte *)surface.getBasePtr(0, 0);
 		byte *dst = (byte *)_surface->getBasePtr(0, 0);
@@ -45,6 +45,9 @@ public:
 	bool create(const Common::String &filename, bool defaultCK, byte ckRed, byte ckGreen, byte ckBlue, int lifeTime = -1, bool keepLoaded = false) override;
 	bool create(int width, int height) override;
 
+	bool invalidate() override;
+	uint32 getDecodedSize() const override;
+
 	bool isTransparentAt(int x, int y) override;
 	bool isTransparentAtLite(int x, int y) override;
 
@@ -97,6 +100,7 @@ public:
 private:
 	Graphics::Surface *_surface;
 	bool _loaded;
+	bool _modified; // Pixels were written by putSurface(), so they can't be decoded again
 	bool finishLoad();
 	bool drawSprite(int x, int y, Rect32 *rect, Rect32 *newRect, Graphics::TransformStruct transformStruct);
 	void genAlphaMask(Graphics::Surface *surface);
@@ -41,7 +41,9 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	_dstRect(*dstRect),
 	_isValid(true),
 	_wantsDraw(true),
-	_transform(transform) {
+	_transform(transform),
+	_nextWithHash(nullptr) {
+	_hash = computeHash();
 	if (surf) {
 		_surface = new Graphics::Surface();
 		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
@@ -95,8 +97,42 @@ RenderTicket::~RenderTicket() {
 	}
 }
 
+uint32 RenderTicket::computeHash() const {
+	const uint32 values[] = {
+		(uint32)(size_t)_owner,
+		(uint32)((_srcRect.left << 16) ^ (uint16)_srcRect.top),
+		(uint32)((_srcRect.right << 16) ^ (uint16)_srcRect.bottom),
+		(uint32)((_dstRect.left << 16) ^ (uint16)_dstRect.top),
+		(uint32)((_dstRect.right << 16) ^ (uint16)_dstRect.bottom),
+		(uint32)((_transform._zoom.x << 16) ^ (uint16)_transform._zoom.y),
+		(uint32)_transform._angle,
+		_transform._rgbaMod,
+		(uint32)((_transform._flip << 8) | (_transform._blendMode << 1) | _transform._alphaDisable)
+	};
+
+	// FNV-1a over the fields which usually differ between tickets; the
+	// remaining ones are left to operator==
+	uint32 hash = 2166136261u;
+	for (uint i = 0; i < ARRAYSIZE(values); i++) {
+		hash = (hash ^ values[i]) * 16777619u;
+	}
+	return hash;
+}
+
+bool RenderTicket::isOpaque() const {
+	// Tiled and rotated tickets may leave gaps, and the color modulation
+	// and blend modes other than the normal one make tickets translucent
+	return _owner && _surface && _transform._alphaDisable &&
+		_transform._angle == Graphics::kDefaultAngle &&
+		_transform._rgbaMod == Graphics::kDefaultRgbaMod &&
+		_transform._blendMode == Graphics::BLEND_NORMAL &&
+		_transform._numTimesX * _transform._numTimesY == 1 &&
+		_surface->w == _dstRect.width() && _surface->h == _dstRect.height();
+}
+
 bool RenderTicket::operator==(const RenderTicket &t) const {
-	if ((t._owner != _owner) ||
+	if ((t._hash != _hash) ||
+		(t._owner != _owner) ||
 		(t._transform != _transform)  ||
 		(t._dstRect != _dstRect) ||
 		(t._srcRect != _srcRect)
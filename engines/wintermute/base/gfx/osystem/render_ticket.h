@@ -31,6 +31,7 @@
 
 #include "graphics/transparent_surface.h"
 #include "graphics/surface.h"
+#include "common/list.h"
 #include "common/rect.h"
 
 namespace Wintermute {
@@ -52,7 +53,7 @@ class BaseSurfaceOSystem;
 class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
-	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
+	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()), _hash(0), _nextWithHash(nullptr) {}
 	~RenderTicket();
 	const Graphics::Surface *getSurface() const { return _surface; }
 	// Non-dirty-rects:
@@ -70,7 +71,22 @@ public:
 	BaseSurfaceOSystem *_owner;
 	bool operator==(const RenderTicket &a) const;
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
+
+	/**
+	 * Whether drawing this ticket replaces every pixel of its destination
+	 * rect, hiding anything drawn there before.
+	 */
+	bool isOpaque() const;
+
+	/** Hash of the draw parameters compared by operator== */
+	uint32 _hash;
+	/** Next ticket from last frame with the same hash, in queue order */
+	RenderTicket *_nextWithHash;
+	/** Position of the ticket in the render queue when it was indexed */
+	Common::List<RenderTicket *>::iterator _queuePos;
 private:
+	uint32 computeHash() const;
+
 	Graphics::Surface *_surface;
 	Common::Rect _srcRect;
 };
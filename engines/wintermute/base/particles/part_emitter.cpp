@@ -66,6 +66,7 @@ PartEmitter::PartEmitter(BaseGame *inGame, BaseScriptHolder *owner) : BaseObject
 	_lifeTimeZBased = false;
 
 	_lastGenTime = 0;
+	_nextDeadParticle = 0;
 	_genInterval = 0;
 	_genAmount = 1;
 
@@ -96,7 +97,7 @@ PartEmitter::PartEmitter(BaseGame *inGame, BaseScriptHolder *owner) : BaseObject
 //////////////////////////////////////////////////////////////////////////
 PartEmitter::~PartEmitter(void) {
 	for (uint32 i = 0; i < _particles.size(); i++) {
-		delete _particles[i];
+		_particlePool.deleteChunk(_particles[i]);
 	}
 	_particles.clear();
 
@@ -237,6 +238,7 @@ bool PartEmitter::initParticle(PartParticle *particle, uint32 currentTime, uint3
 	particle->_angVelocity = angVelocity;
 	particle->_growthRate = growthRate;
 	particle->_exponentialGrowth = _exponentialGrowth;
+	reuseSprite(particle, _sprites[spriteIndex]);
 	particle->_isDead = DID_FAIL(particle->setSprite(_sprites[spriteIndex]));
 	particle->fadeIn(currentTime, _fadeInTime);
 
@@ -248,6 +250,23 @@ bool PartEmitter::initParticle(PartParticle *particle, uint32 currentTime, uint3
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+void PartEmitter::reuseSprite(PartParticle *particle, const char *filename) {
+	// Loading a sprite is expensive, so swap with a dead particle that
+	// still has the right one loaded, if the particle's own doesn't match
+	if (!particle->_sprite || particle->hasSprite(filename)) {
+		return;
+	}
+
+	for (uint32 i = _nextDeadParticle; i < _deadParticles.size(); i++) {
+		PartParticle *donor = _deadParticles[i];
+		if (donor->hasSprite(filename)) {
+			SWAP(particle->_sprite, donor->_sprite);
+			return;
+		}
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool PartEmitter::update() {
 	if (!_running) {
@@ -261,10 +280,32 @@ bool PartEmitter::update() {
 bool PartEmitter::updateInternal(uint32 currentTime, uint32 timerDelta) {
 	int numLive = 0;
 
+	const float elapsedTime = (float)timerDelta / 1000.f;
+	_globalForceDelta = Vector2(0.0f, 0.0f);
+	_pointForces.resize(0);
+	for (uint32 i = 0; i < _forces.size(); i++) {
+		PartForce *force = _forces[i];
+		if (force->_type == PartForce::FORCE_GLOBAL) {
+			_globalForceDelta += force->_direction * elapsedTime;
+		} else if (force->_type == PartForce::FORCE_POINT) {
+			_pointForces.add(force);
+		}
+	}
+
+	// Dead particles stay dead until they are reused, so there is no point
+	// in updating them. Remember them instead, so that new particles don't
+	// have to search for a free slot. Resizing keeps the storage.
+	_deadParticles.resize(0);
+	_nextDeadParticle = 0;
 	for (uint32 i = 0; i < _particles.size(); i++) {
-		_particles[i]->update(this, currentTime, timerDelta);
+		PartParticle *particle = _particles[i];
+		if (!particle->_isDead) {
+			particle->update(this, currentTime, timerDelta);
+		}
 
-		if (!_particles[i]->_isDead) {
+		if (particle->_isDead) {
+			_deadParticles.add(particle);
+		} else {
 			numLive++;
 		}
 	}
@@ -283,22 +324,19 @@ bool PartEmitter::updateInternal(uint32 currentTime, uint32 timerDelta) {
 
 			int toGen = MIN(_genAmount, _maxParticles - numLive);
 			while (toGen > 0) {
-				int firstDeadIndex = -1;
-				for (uint32 i = 0; i < _particles.size(); i++) {
-					if (_particles[i]->_isDead) {
-						firstDeadIndex = i;
-						break;
-					}
-				}
-
-				PartParticle *particle;
-				if (firstDeadIndex >= 0) {
-					particle = _particles[firstDeadIndex];
-				} else {
-					particle = new PartParticle(_gameRef);
+				if (_nextDeadParticle >= _deadParticles.size()) {
+					PartParticle *particle = new (_particlePool) PartParticle(_gameRef);
 					_particles.add(particle);
+					_deadParticles.add(particle);
 				}
+
+				// A particle whose sprite failed to load stays dead and is
+				// the first one to be tried again
+				PartParticle *particle = _deadParticles[_nextDeadParticle];
 				initParticle(particle, currentTime, timerDelta);
+				if (!particle->_isDead) {
+					_nextDeadParticle++;
+				}
 				needsSort = true;
 
 				toGen--;
@@ -326,6 +364,9 @@ bool PartEmitter::display(BaseRegion *region) {
 	}
 
 	for (uint32 i = 0; i < _particles.size(); i++) {
+		if (_particles[i]->_isDead) {
+			continue;
+		}
 		if (region != nullptr && _useRegion) {
 			if (!region->pointInRegion((int)_particles[i]->_pos.x, (int)_particles[i]->_pos.y)) {
 				continue;
@@ -525,9 +566,11 @@ bool PartEmitter::scCallMethod(ScScript *script, ScStack *stack, ScStack *thisSt
 		stack->correctParams(0);
 
 		for (uint32 i = 0; i < _particles.size(); i++) {
-			delete _particles[i];
+			_particlePool.deleteChunk(_particles[i]);
 		}
 		_particles.clear();
+		_deadParticles.clear();
+		_nextDeadParticle = 0;
 
 		_running = false;
 		stack->pushBool(true);
@@ -1244,7 +1287,7 @@ bool PartEmitter::persist(BasePersistenceManager *persistMgr) {
 	} else {
 		persistMgr->transferUint32(TMEMBER(numParticles));
 		for (uint32 i = 0; i < numParticles; i++) {
-			PartParticle *particle = new PartParticle(_gameRef);
+			PartParticle *particle = new (_particlePool) PartParticle(_gameRef);
 			particle->persist(persistMgr);
 			_particles.add(particle);
 		}
@@ -30,12 +30,13 @@
 #define WINTERMUTE_PARTEMITTER_H
 
 
+#include "common/memorypool.h"
 #include "engines/wintermute/base/base_object.h"
 #include "engines/wintermute/base/particles/part_force.h"
+#include "engines/wintermute/base/particles/part_particle.h"
 
 namespace Wintermute {
 class BaseRegion;
-class PartParticle;
 class PartEmitter : public BaseObject {
 public:
 	DECLARE_PERSISTENT(PartEmitter, BaseObject)
@@ -61,6 +62,11 @@ public:
 	bool removeForce(const Common::String &name);
 
 	BaseArray<PartForce *> _forces;
+	// Set up by updateInternal() for the particles: the velocity change by
+	// all global forces, which is the same for every particle, and the
+	// forces which depend on the particle position
+	Vector2 _globalForceDelta;
+	BaseArray<PartForce *> _pointForces;
 
 	// scripting interface
 	ScValue *scGetProperty(const Common::String &name) override;
@@ -129,9 +135,16 @@ private:
 	PartForce *addForceByName(const Common::String &name);
 	bool static compareZ(const PartParticle *p1, const PartParticle *p2);
 	bool initParticle(PartParticle *particle, uint32 currentTime, uint32 timerDelta);
+	void reuseSprite(PartParticle *particle, const char *filename);
 	bool updateInternal(uint32 currentTime, uint32 timerDelta);
 	uint32 _lastGenTime;
 	BaseArray<PartParticle *> _particles;
+	// Keeps the particles next to each other in memory, and their chunks
+	// for reuse when a particle set is stopped and started again
+	Common::ObjectPool<PartParticle, 0> _particlePool;
+	// Dead particles in the order of _particles, collected by updateInternal()
+	BaseArray<PartParticle *> _deadParticles;
+	uint32 _nextDeadParticle;
 	BaseArray<char *> _sprites;
 };
 
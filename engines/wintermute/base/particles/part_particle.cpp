@@ -70,7 +70,7 @@ PartParticle::~PartParticle(void) {
 
 //////////////////////////////////////////////////////////////////////////
 bool PartParticle::setSprite(const Common::String &filename) {
-	if (_sprite && _sprite->getFilename() && scumm_stricmp(filename.c_str(), _sprite->getFilename()) == 0) {
+	if (hasSprite(filename.c_str())) {
 		_sprite->reset();
 		return STATUS_OK;
 	}
@@ -92,6 +92,11 @@ bool PartParticle::setSprite(const Common::String &filename) {
 
 }
 
+//////////////////////////////////////////////////////////////////////////
+bool PartParticle::hasSprite(const char *filename) {
+	return _sprite && _sprite->getFilename() && scumm_stricmp(filename, _sprite->getFilename()) == 0;
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool PartParticle::update(PartEmitter *emitter, uint32 currentTime, uint32 timerDelta) {
 	if (_state == PARTICLE_FADEIN) {
@@ -148,26 +153,15 @@ bool PartParticle::update(PartEmitter *emitter, uint32 currentTime, uint32 timer
 		// update position
 		float elapsedTime = (float)timerDelta / 1000.f;
 
-		for (uint32 i = 0; i < emitter->_forces.size(); i++) {
-			PartForce *force = emitter->_forces[i];
-			switch (force->_type) {
-			case PartForce::FORCE_GLOBAL:
-				_velocity += force->_direction * elapsedTime;
-				break;
-
-			case PartForce::FORCE_POINT: {
-				Vector2 vecDist = force->_pos - _pos;
-				float dist = fabs(vecDist.length());
+		_velocity += emitter->_globalForceDelta;
+		for (uint32 i = 0; i < emitter->_pointForces.size(); i++) {
+			PartForce *force = emitter->_pointForces[i];
+			Vector2 vecDist = force->_pos - _pos;
+			float dist = fabs(vecDist.length());
 
-				dist = 100.0f / dist;
+			dist = 100.0f / dist;
 
-				_velocity += force->_direction * dist * elapsedTime;
-			}
-			break;
-
-			default:
-				break;
-			}
+			_velocity += force->_direction * dist * elapsedTime;
 		}
 		_pos += _velocity * elapsedTime;
 
@@ -73,6 +73,7 @@ public:
 	bool display(PartEmitter *emitter);
 
 	bool setSprite(const Common::String &filename);
+	bool hasSprite(const char *filename);
 
 	bool fadeIn(uint32 currentTime, int fadeTime);
 	bool fadeOut(uint32 currentTime, int fadeTime);
@@ -173,9 +173,12 @@ bool ScScript::initTables() {
 
 	_numSymbols = getDWORD();
 	_symbols = new char*[_numSymbols];
+	releaseSymbolAtoms();
+	_symbolAtoms.resize(_numSymbols);
 	for (uint32 i = 0; i < _numSymbols; i++) {
 		uint32 index = getDWORD();
 		_symbols[index] = getString();
+		_symbolAtoms[index] = BaseEngine::instance().getAtoms().intern(_symbols[index]);
 	}
 
 	// load functions table
@@ -398,6 +401,7 @@ void ScScript::cleanup() {
 		delete[] _symbols;
 	}
 	_symbols = nullptr;
+	releaseSymbolAtoms();
 	_numSymbols = 0;
 
 	if (_globals && !_thread) {
@@ -535,9 +539,9 @@ bool ScScript::executeInstruction() {
 		_operand->setNULL();
 		dw = getDWORD();
 		if (_scopeStack->_sP < 0) {
-			_globals->setProp(_symbols[dw], _operand);
+			_globals->setProp(_symbolAtoms[dw], _operand);
 		} else {
-			_scopeStack->getTop()->setProp(_symbols[dw], _operand);
+			_scopeStack->getTop()->setProp(_symbolAtoms[dw], _operand);
 		}
 
 		break;
@@ -547,9 +551,9 @@ bool ScScript::executeInstruction() {
 		dw = getDWORD();
 		/*      char *temp = _symbols[dw]; // TODO delete */
 		// only create global var if it doesn't exist
-		if (!_engine->_globals->propExists(_symbols[dw])) {
+		if (!_engine->_globals->propExists(_symbolAtoms[dw])) {
 			_operand->setNULL();
-			_engine->_globals->setProp(_symbols[dw], _operand, false, inst == II_DEF_CONST_VAR);
+			_engine->_globals->setProp(_symbolAtoms[dw], _operand, false, inst == II_DEF_CONST_VAR);
 		}
 		break;
 	}
@@ -705,7 +709,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_VAR: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getVar(_symbolAtoms[getDWORD()]);
 		if (false && /*var->_type==VAL_OBJECT ||*/ var->_type == VAL_NATIVE) {
 			_operand->setReference(var);
 			_stack->push(_operand);
@@ -716,15 +720,14 @@ bool ScScript::executeInstruction() {
 	}
 
 	case II_PUSH_VAR_REF: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getVar(_symbolAtoms[getDWORD()]);
 		_operand->setReference(var);
 		_stack->push(_operand);
 		break;
 	}
 
 	case II_POP_VAR: {
-		char *varName = _symbols[getDWORD()];
-		ScValue *var = getVar(varName);
+		ScValue *var = getVar(_symbolAtoms[getDWORD()]);
 		if (var) {
 			ScValue *val = _stack->pop();
 			if (!val) {
@@ -777,7 +780,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_THIS:
-		_operand->setReference(getVar(_symbols[getDWORD()]));
+		_operand->setReference(getVar(_symbolAtoms[getDWORD()]));
 		_thisStack->push(_operand);
 		break;
 
@@ -1134,42 +1137,63 @@ uint32 ScScript::getMethodPos(const Common::String &name) const {
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+void ScScript::releaseSymbolAtoms() {
+	ScAtomTable &atoms = BaseEngine::instance().getAtoms();
+	for (uint32 i = 0; i < _symbolAtoms.size(); i++) {
+		atoms.release(_symbolAtoms[i]);
+	}
+	_symbolAtoms.clear();
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 ScValue *ScScript::getVar(char *name) {
+	ScAtomTable &atoms = BaseEngine::instance().getAtoms();
+	ScAtom atom = atoms.intern(name);
+	ScValue *ret = getVar(atom);
+	atoms.release(atom);
+	return ret;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::getVar(ScAtom atom) {
 	ScValue *ret = nullptr;
 
 	// scope locals
 	if (_scopeStack->_sP >= 0) {
-		if (_scopeStack->getTop()->propExists(name)) {
-			ret = _scopeStack->getTop()->getProp(name);
+		if (_scopeStack->getTop()->propExists(atom)) {
+			ret = _scopeStack->getTop()->getProp(atom);
 		}
 	}
 
 	// script globals
 	if (ret == nullptr) {
-		if (_globals->propExists(name)) {
-			ret = _globals->getProp(name);
+		if (_globals->propExists(atom)) {
+			ret = _globals->getProp(atom);
 		}
 	}
 
 	// engine globals
 	if (ret == nullptr) {
-		if (_engine->_globals->propExists(name)) {
-			ret = _engine->_globals->getProp(name);
+		if (_engine->_globals->propExists(atom)) {
+			ret = _engine->_globals->getProp(atom);
 		}
 	}
 
 	if (ret == nullptr) {
+		const char *name = BaseEngine::instance().getAtoms().getName(atom).c_str();
 		//RuntimeError("Variable '%s' is inaccessible in the current block. Consider changing the script.", name);
 		_gameRef->LOG(0, "Warning: variable '%s' is inaccessible in the current block. Consider changing the script (script:%s, line:%d)", name, _filename, _currentLine);
 		ScValue *val = new ScValue(_gameRef);
 		ScValue *scope = _scopeStack->getTop();
 		if (scope) {
-			scope->setProp(name, val);
-			ret = _scopeStack->getTop()->getProp(name);
+			scope->setProp(atom, val);
+			ret = _scopeStack->getTop()->getProp(atom);
 		} else {
-			_globals->setProp(name, val);
-			ret = _globals->getProp(name);
+			_globals->setProp(atom, val);
+			ret = _globals->getProp(atom);
 		}
 		delete val;
 	}
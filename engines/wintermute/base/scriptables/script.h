@@ -32,6 +32,7 @@
 
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "engines/wintermute/base/scriptables/script_atoms.h"
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/persistent.h"
 
@@ -80,6 +81,7 @@ public:
 	TScriptState _state;
 	TScriptState _origState;
 	ScValue *getVar(char *name);
+	ScValue *getVar(ScAtom atom);
 	uint32 getFuncPos(const Common::String &name);
 	uint32 getEventPos(const Common::String &name) const;
 	uint32 getMethodPos(const Common::String &name) const;
@@ -152,6 +154,7 @@ public:
 	bool externalCall(ScStack *stack, ScStack *thisStack, ScScript::TExternalFunction *function);
 private:
 	char **_symbols;
+	Common::Array<ScAtom> _symbolAtoms;
 	uint32 _numSymbols;
 	TFunctionPos *_functions;
 	TMethodPos *_methods;
@@ -164,6 +167,7 @@ private:
 
 	bool initScript();
 	bool initTables();
+	void releaseSymbolAtoms();
 
 	virtual void preInstHook(uint32 inst);
 	virtual void postInstHook(uint32 inst);
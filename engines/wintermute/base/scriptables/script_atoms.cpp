@@ -0,0 +1,85 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/base/scriptables/script_atoms.h"
+
+namespace Wintermute {
+
+//////////////////////////////////////////////////////////////////////////
+ScAtomTable::ScAtomTable() {
+	// Reserve kScNoAtom
+	_names.push_back(nullptr);
+	_refCounts.push_back(0);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScAtom ScAtomTable::intern(const char *name) {
+	Common::HashMap<Common::String, ScAtom>::iterator it = _atoms.find(name);
+	if (it != _atoms.end()) {
+		_refCounts[it->_value]++;
+		return it->_value;
+	}
+
+	ScAtom atom;
+	if (!_freeAtoms.empty()) {
+		atom = _freeAtoms.back();
+		_freeAtoms.pop_back();
+	} else {
+		atom = _names.size();
+		_names.push_back(nullptr);
+		_refCounts.push_back(0);
+	}
+	_atoms[name] = atom;
+	_names[atom] = &_atoms.find(name)->_key;
+	_refCounts[atom] = 1;
+	return atom;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScAtomTable::release(ScAtom atom) {
+	if (atom >= _refCounts.size() || _refCounts[atom] == 0) {
+		return;
+	}
+	if (--_refCounts[atom] > 0) {
+		return;
+	}
+
+	// Copy the name, as it is the key that gets erased
+	Common::String name = *_names[atom];
+	_atoms.erase(name);
+	_names[atom] = nullptr;
+	_freeAtoms.push_back(atom);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScAtom ScAtomTable::find(const char *name) const {
+	Common::HashMap<Common::String, ScAtom>::const_iterator it = _atoms.find(name);
+	if (it != _atoms.end()) {
+		return it->_value;
+	}
+	return kScNoAtom;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_SCATOMS_H
+#define WINTERMUTE_SCATOMS_H
+
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace Wintermute {
+
+/**
+ * Identifies an interned variable or property name. Atoms are only valid for
+ * the lifetime of the table that handed them out and are never saved.
+ */
+typedef uint32 ScAtom;
+
+enum {
+	kScNoAtom = 0
+};
+
+/**
+ * Maps script identifiers to small integers, so that variable and property
+ * lookups hash and compare an integer instead of a string. Atoms are
+ * reference counted, so that the names of dynamic properties and array
+ * indices are dropped again with the last value that uses them; freed atoms
+ * are handed out again for new names.
+ */
+class ScAtomTable {
+public:
+	ScAtomTable();
+
+	/**
+	 * Returns the atom of the given name, adding it if necessary. The caller
+	 * owns a reference to the atom and has to release() it.
+	 */
+	ScAtom intern(const char *name);
+
+	/**
+	 * Returns the atom of the given name, or kScNoAtom if it is unknown.
+	 * Doesn't add a reference.
+	 */
+	ScAtom find(const char *name) const;
+
+	void addRef(ScAtom atom) { _refCounts[atom]++; }
+
+	/**
+	 * Drops a reference to the atom, and the atom itself with the last one.
+	 * Atoms this table doesn't know are ignored, as scripts may be destroyed
+	 * after the engine instance that owned the table.
+	 */
+	void release(ScAtom atom);
+
+	/** Only valid for atoms which are referenced. */
+	const Common::String &getName(ScAtom atom) const { return *_names[atom]; }
+	uint32 getRefCount(ScAtom atom) const { return atom < _refCounts.size() ? _refCounts[atom] : 0; }
+	uint32 size() const { return _atoms.size(); }
+
+private:
+	Common::HashMap<Common::String, ScAtom> _atoms;
+	// Point to the keys of _atoms, which stay put when the map grows
+	Common::Array<const Common::String *> _names;
+	Common::Array<uint32> _refCounts;
+	Common::Array<ScAtom> _freeAtoms;
+};
+
+} // End of namespace Wintermute
+
+#endif
@@ -28,6 +28,7 @@
 
 #include "engines/wintermute/platform_osystem.h"
 #include "engines/wintermute/base/base_dynamic_buffer.h"
+#include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/base/scriptables/script.h"
@@ -183,21 +184,43 @@ ScValue *ScValue::getProp(const char *name) {
 	}
 
 	if (ret == nullptr) {
-		_valIter = _valObject.find(name);
-		if (_valIter != _valObject.end()) {
-			ret = _valIter->_value;
+		// A name nobody has interned can't be a property
+		ScAtom atom = BaseEngine::instance().getAtoms().find(name);
+		if (atom != kScNoAtom) {
+			_valIter = _valObject.find(atom);
+			if (_valIter != _valObject.end()) {
+				ret = _valIter->_value;
+			}
 		}
 	}
 	return ret;
 }
 
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScValue::getProp(ScAtom atom) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->getProp(atom);
+	}
+
+	// Strings and natives resolve their built-in properties by name
+	if (_type == VAL_STRING || (_type == VAL_NATIVE && _valNative)) {
+		return getProp(BaseEngine::instance().getAtoms().getName(atom).c_str());
+	}
+
+	_valIter = _valObject.find(atom);
+	if (_valIter != _valObject.end()) {
+		return _valIter->_value;
+	}
+	return nullptr;
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::deleteProp(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
 		return _valRef->deleteProp(name);
 	}
 
-	_valIter = _valObject.find(name);
+	_valIter = _valObject.find(BaseEngine::instance().getAtoms().find(name));
 	if (_valIter != _valObject.end()) {
 		delete _valIter->_value;
 		_valIter->_value = nullptr;
@@ -210,19 +233,29 @@ bool ScValue::deleteProp(const char *name) {
 
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::setProp(const char *name, ScValue *val, bool copyWhole, bool setAsConst) {
+	ScAtomTable &atoms = BaseEngine::instance().getAtoms();
+	ScAtom atom = atoms.intern(name);
+	bool ret = setProp(atom, val, copyWhole, setAsConst);
+	atoms.release(atom);
+	return ret;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool ScValue::setProp(ScAtom atom, ScValue *val, bool copyWhole, bool setAsConst) {
 	if (_type == VAL_VARIABLE_REF) {
-		return _valRef->setProp(name, val);
+		return _valRef->setProp(atom, val);
 	}
 
 	bool ret = STATUS_FAILED;
 	if (_type == VAL_NATIVE && _valNative) {
-		ret = _valNative->scSetProperty(name, val);
+		ret = _valNative->scSetProperty(BaseEngine::instance().getAtoms().getName(atom).c_str(), val);
 	}
 
 	if (DID_FAIL(ret)) {
 		ScValue *newVal = nullptr;
 
-		_valIter = _valObject.find(name);
+		_valIter = _valObject.find(atom);
 		if (_valIter != _valObject.end()) {
 			newVal = _valIter->_value;
 		}
@@ -234,7 +267,7 @@ bool ScValue::setProp(const char *name, ScValue *val, bool copyWhole, bool setAs
 
 		newVal->copy(val, copyWhole);
 		newVal->_isConstVar = setAsConst;
-		_valObject[name] = newVal;
+		storeProp(atom, newVal);
 
 		if (_type != VAL_NATIVE) {
 			_type = VAL_OBJECT;
@@ -264,7 +297,18 @@ bool ScValue::propExists(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
 		return _valRef->propExists(name);
 	}
-	_valIter = _valObject.find(name);
+	_valIter = _valObject.find(BaseEngine::instance().getAtoms().find(name));
+
+	return (_valIter != _valObject.end());
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool ScValue::propExists(ScAtom atom) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->propExists(atom);
+	}
+	_valIter = _valObject.find(atom);
 
 	return (_valIter != _valObject.end());
 }
@@ -277,6 +321,28 @@ void ScValue::deleteProps() {
 		delete(ScValue *)_valIter->_value;
 		_valIter++;
 	}
+	clearProps();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScValue::storeProp(ScAtom atom, ScValue *val) {
+	_valIter = _valObject.find(atom);
+	if (_valIter != _valObject.end()) {
+		_valIter->_value = val;
+	} else {
+		BaseEngine::instance().getAtoms().addRef(atom);
+		_valObject[atom] = val;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScValue::clearProps() {
+	ScAtomTable &atoms = BaseEngine::instance().getAtoms();
+	for (_valIter = _valObject.begin(); _valIter != _valObject.end(); ++_valIter) {
+		atoms.release(_valIter->_key);
+	}
 	_valObject.clear();
 }
 
@@ -743,12 +809,13 @@ void ScValue::copy(ScValue *orig, bool copyWhole) {
 	if (orig->_type == VAL_OBJECT && orig->_valObject.size() > 0) {
 		orig->_valIter = orig->_valObject.begin();
 		while (orig->_valIter != orig->_valObject.end()) {
-			_valObject[orig->_valIter->_key] = new ScValue(_gameRef);
-			_valObject[orig->_valIter->_key]->copy(orig->_valIter->_value);
+			ScValue *val = new ScValue(_gameRef);
+			val->copy(orig->_valIter->_value);
+			storeProp(orig->_valIter->_key, val);
 			orig->_valIter++;
 		}
 	} else {
-		_valObject.clear();
+		clearProps();
 	}
 }
 
@@ -806,7 +873,7 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 		persistMgr->transferSint32("", &size);
 		_valIter = _valObject.begin();
 		while (_valIter != _valObject.end()) {
-			str = _valIter->_key.c_str();
+			str = BaseEngine::instance().getAtoms().getName(_valIter->_key).c_str();
 			persistMgr->transferConstChar("", &str);
 			persistMgr->transferPtr("", &_valIter->_value);
 
@@ -819,7 +886,10 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 			persistMgr->transferConstChar("", &str);
 			persistMgr->transferPtr("", &val);
 
-			_valObject[str] = val;
+			ScAtomTable &atoms = BaseEngine::instance().getAtoms();
+			ScAtom atom = atoms.intern(str);
+			storeProp(atom, val);
+			atoms.release(atom);
 			delete[] str;
 		}
 	}
@@ -887,7 +957,7 @@ bool ScValue::saveAsText(BaseDynamicBuffer *buffer, int indent) {
 	_valIter = _valObject.begin();
 	while (_valIter != _valObject.end()) {
 		buffer->putTextIndent(indent, "PROPERTY {\n");
-		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", _valIter->_key.c_str());
+		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", BaseEngine::instance().getAtoms().getName(_valIter->_key).c_str());
 		buffer->putTextIndent(indent + 2, "VALUE=\"%s\"\n", _valIter->_value->getString());
 		buffer->putTextIndent(indent, "}\n\n");
 
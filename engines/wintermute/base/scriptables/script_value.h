@@ -33,6 +33,7 @@
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "engines/wintermute/base/scriptables/script_atoms.h"
 #include "common/str.h"
 
 namespace Wintermute {
@@ -53,6 +54,7 @@ public:
 	void setValue(ScValue *val);
 	bool _persistent;
 	bool propExists(const char *name);
+	bool propExists(ScAtom atom);
 	void copy(ScValue *orig, bool copyWhole = false);
 	void setStringVal(const char *val);
 	TValType getType();
@@ -82,10 +84,15 @@ public:
 	bool isInt();
 	bool isObject();
 	bool setProp(const char *name, ScValue *val, bool copyWhole = false, bool setAsConst = false);
+	bool setProp(ScAtom atom, ScValue *val, bool copyWhole = false, bool setAsConst = false);
 	ScValue *getProp(const char *name);
+	ScValue *getProp(ScAtom atom);
 	BaseScriptable *_valNative;
 	ScValue *_valRef;
 private:
+	// Entries of _valObject hold a reference to the atom of their name
+	void storeProp(ScAtom atom, ScValue *val);
+	void clearProps();
 	bool _valBool;
 	int32 _valInt;
 	double _valFloat;
@@ -98,8 +105,9 @@ public:
 	ScValue(BaseGame *inGame, double Val);
 	ScValue(BaseGame *inGame, const char *Val);
 	~ScValue() override;
-	Common::HashMap<Common::String, ScValue *> _valObject;
-	Common::HashMap<Common::String, ScValue *>::iterator _valIter;
+	// Keyed by the atoms of the property names
+	Common::HashMap<ScAtom, ScValue *> _valObject;
+	Common::HashMap<ScAtom, ScValue *>::iterator _valIter;
 
 	bool setProperty(const char *propName, int32 value);
 	bool setProperty(const char *propName, const char *value);
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/dirty_region.h"
+#include "common/algorithm.h"
+
+namespace Graphics {
+
+DirtyRegion::DirtyRegion() : _width(0), _height(0), _columns(0), _rows(0), _pitch(0), _firstRow(0), _lastRow(-1) {
+}
+
+DirtyRegion::DirtyRegion(int width, int height) : _width(0), _height(0), _columns(0), _rows(0), _pitch(0), _firstRow(0), _lastRow(-1) {
+	setSize(width, height);
+}
+
+void DirtyRegion::setSize(int width, int height) {
+	_width = MAX(width, 0);
+	_height = MAX(height, 0);
+	_columns = (_width + kTileSize - 1) >> kTileShift;
+	_rows = (_height + kTileSize - 1) >> kTileShift;
+	_pitch = (_columns + 31) / 32;
+
+	_tiles.clear();
+	_tiles.resize(_pitch * _rows);
+	Common::fill(_tiles.begin(), _tiles.end(), 0);
+	_firstRow = _rows;
+	_lastRow = -1;
+}
+
+void DirtyRegion::addRect(const Common::Rect &r) {
+	const int left = MAX<int>(r.left, 0);
+	const int top = MAX<int>(r.top, 0);
+	const int right = MIN<int>(r.right, _width);
+	const int bottom = MIN<int>(r.bottom, _height);
+	if (left >= right || top >= bottom)
+		return;
+
+	const int col0 = left >> kTileShift;
+	const int col1 = (right - 1) >> kTileShift;
+	const int row0 = top >> kTileShift;
+	const int row1 = (bottom - 1) >> kTileShift;
+
+	const uint word0 = col0 >> 5;
+	const uint word1 = col1 >> 5;
+	const uint32 mask0 = 0xFFFFFFFF << (col0 & 31);
+	const uint32 mask1 = 0xFFFFFFFF >> (31 - (col1 & 31));
+
+	for (int row = row0; row <= row1; ++row) {
+		uint32 *words = &_tiles[row * _pitch];
+		if (word0 == word1) {
+			words[word0] |= mask0 & mask1;
+		} else {
+			words[word0] |= mask0;
+			for (uint word = word0 + 1; word < word1; ++word)
+				words[word] = 0xFFFFFFFF;
+			words[word1] |= mask1;
+		}
+	}
+
+	_firstRow = MIN(_firstRow, row0);
+	_lastRow = MAX(_lastRow, row1);
+}
+
+void DirtyRegion::markAllDirty() {
+	addRect(Common::Rect(0, 0, _width, _height));
+}
+
+void DirtyRegion::clear() {
+	if (isEmpty())
+		return;
+
+	Common::fill(&_tiles[_firstRow * _pitch], &_tiles[0] + (_lastRow + 1) * _pitch, 0);
+	_firstRow = _rows;
+	_lastRow = -1;
+}
+
+void DirtyRegion::getRects(Common::Array<Common::Rect> &rects) const {
+	// Rectangles which end in the previous tile row. They can be extended
+	// downwards by a run in the current row with the same extent.
+	Common::Array<uint> openRects[2];
+	uint current = 0;
+
+	for (int row = _firstRow; row <= _lastRow; ++row) {
+		const uint32 *words = &_tiles[row * _pitch];
+		const int16 top = row << kTileShift;
+		const int16 bottom = MIN((row + 1) << kTileShift, _height);
+		const Common::Array<uint> &open = openRects[current];
+		Common::Array<uint> &next = openRects[current ^ 1];
+		uint openPos = 0;
+		next.clear();
+
+		int col = 0;
+		while (col < _columns) {
+			// Find the start of the next run, skipping clean words at once
+			uint32 bits = words[col >> 5] >> (col & 31);
+			if (!bits) {
+				col = (col | 31) + 1;
+				continue;
+			}
+			while (!(bits & 1)) {
+				bits >>= 1;
+				++col;
+			}
+
+			const int start = col;
+			while (col < _columns && (words[col >> 5] & (1u << (col & 31))))
+				++col;
+
+			const int16 left = start << kTileShift;
+			const int16 right = MIN(col << kTileShift, _width);
+
+			// Both the open rectangles and the runs are ordered from left to
+			// right, so a single pass over the open ones is enough
+			while (openPos < open.size() && rects[open[openPos]].right <= left)
+				++openPos;
+
+			if (openPos < open.size() && rects[open[openPos]].left == left && rects[open[openPos]].right == right) {
+				rects[open[openPos]].bottom = bottom;
+				next.push_back(open[openPos]);
+				++openPos;
+			} else {
+				next.push_back(rects.size());
+				rects.push_back(Common::Rect(left, top, right, bottom));
+			}
+		}
+
+		current ^= 1;
+	}
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTY_REGION_H
+#define GRAPHICS_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+#include "common/types.h"
+
+namespace Graphics {
+
+/**
+ * Keeps track of the modified areas of a surface as a bitmap of fixed size
+ * tiles. Adding a rectangle only sets the bits of the tiles it covers, so
+ * unlike a plain list of rectangles there is nothing to merge afterwards,
+ * no matter how many rectangles get added. getRects() turns the bitmap into
+ * a small set of non-overlapping rectangles, by coalescing runs of dirty
+ * tiles within a tile row and identical runs of consecutive tile rows.
+ */
+class DirtyRegion {
+public:
+	enum {
+		kTileShift = 4,
+		kTileSize = 1 << kTileShift
+	};
+
+	DirtyRegion();
+	DirtyRegion(int width, int height);
+
+	/**
+	 * Sets the size of the tracked area. This discards all dirty tiles.
+	 */
+	void setSize(int width, int height);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+
+	/**
+	 * Marks the tiles covered by the given rectangle as dirty. The rectangle
+	 * is clipped to the tracked area.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Marks the whole area as dirty
+	 */
+	void markAllDirty();
+
+	/**
+	 * Marks the whole area as clean
+	 */
+	void clear();
+
+	/**
+	 * Returns true if no tile is dirty
+	 */
+	bool isEmpty() const { return _firstRow > _lastRow; }
+
+	/**
+	 * Appends a set of non-overlapping rectangles covering all dirty tiles
+	 * to the given array. The rectangles are clipped to the tracked area and
+	 * sorted by their top edge.
+	 */
+	void getRects(Common::Array<Common::Rect> &rects) const;
+
+private:
+	int _width, _height;
+	int _columns, _rows;
+
+	/** Number of bitmap words per tile row */
+	uint _pitch;
+
+	/** One bit per tile, row by row */
+	Common::Array<uint32> _tiles;
+
+	/** Range of tile rows which may contain dirty tiles */
+	int _firstRow, _lastRow;
+};
+
+} // End of namespace Graphics
+
+#endif
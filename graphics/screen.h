@@ -23,8 +23,10 @@
 #ifndef GRAPHICS_SCREEN_H
 #define GRAPHICS_SCREEN_H
 
+#include "graphics/dirty_region.h"
 #include "graphics/managed_surface.h"
 #include "graphics/pixelformat.h"
+#include "common/array.h"
 #include "common/list.h"
 #include "common/rect.h"
 
@@ -42,20 +44,15 @@ namespace Graphics {
 class Screen : public ManagedSurface {
 protected:
 	/**
-	 * List of affected areas of the screen
+	 * Affected areas of the screen
 	 */
-	Common::List<Common::Rect> _dirtyRects;
-protected:
-	/**
-	 * Merges together overlapping dirty areas of the screen
-	 */
-	void mergeDirtyRects();
+	DirtyRegion _dirtyRegion;
 
 	/**
-	 * Returns the union of two dirty area rectangles
+	 * Scratch list of the areas copied by update
 	 */
-	bool unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2);
-
+	Common::Array<Common::Rect> _updateRects;
+protected:
 	/**
 	 * Adds a rectangle to the list of modified areas of the screen during the
 	 * current frame
@@ -69,7 +66,12 @@ public:
 	/**
 	 * Returns true if there are any pending screen updates (dirty areas)
 	 */
-	bool isDirty() const { return !_dirtyRects.empty(); }
+	bool isDirty() const { return !_dirtyRegion.isEmpty(); }
+
+	/**
+	 * Returns non-overlapping rectangles covering the pending dirty areas
+	 */
+	void getDirtyRects(Common::Array<Common::Rect> &rects) const { _dirtyRegion.getRects(rects); }
 
 	/**
 	 * Marks the whole screen as dirty. This forces the next call to update
@@ -80,7 +82,7 @@ public:
 	/**
 	 * Clear the current dirty rects list
 	 */
-	virtual void clearDirtyRects() { _dirtyRects.clear(); }
+	virtual void clearDirtyRects() { _dirtyRegion.clear(); }
 
 	/**
 	 * Updates the screen by copying any affected areas to the system
@@ -0,0 +1,229 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "common/ptr.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "graphics/pixelformat.h"
+
+#include "helper.h"
+
+/**
+ * Timer manager which only remembers its callback, so that the test can run
+ * the decoder whenever it likes.
+ */
+class DecodeAheadTestTimerManager : public Common::TimerManager {
+public:
+	Common::TimerManager::TimerProc _proc;
+	void *_refCon;
+
+	DecodeAheadTestTimerManager() : _proc(nullptr), _refCon(nullptr) {}
+
+	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id) {
+		_proc = proc;
+		_refCon = refCon;
+		return true;
+	}
+
+	virtual void removeTimerProc(TimerProc proc) {
+		if (_proc == proc)
+			_proc = nullptr;
+	}
+
+	void tick() {
+		if (_proc)
+			_proc(_refCon);
+	}
+};
+
+/**
+ * The parts of OSystem the decode ahead streams need: mutexes, which can be
+ * dummies since the test is single threaded, and the timer manager.
+ */
+class DecodeAheadTestSystem : public OSystem {
+public:
+	DecodeAheadTestTimerManager *_timer;
+
+	DecodeAheadTestSystem() {
+		_timer = new DecodeAheadTestTimerManager();
+		_timerManager = _timer;
+	}
+
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return nullptr; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return nullptr; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeXOffset, int shakeYOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+	virtual uint32 getMillis(bool skipRecord) { return 0; }
+	virtual void delayMillis(uint msecs) {}
+	virtual void getTimeAndDate(TimeDate &t) const {}
+	virtual MutexRef createMutex() { return (MutexRef)this; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+	virtual Audio::Mixer *getMixer() { return nullptr; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+class DecodeAheadAudioStreamTestSuite : public CxxTest::TestSuite {
+	enum {
+		kRate = 11025,
+		kSeconds = 2,
+		kLookahead = 500,
+		kChunkLength = 20	/**< Milliseconds of audio decoded per stream and tick */
+	};
+
+	DecodeAheadTestSystem *_system;
+	OSystem *_oldSystem;
+
+	static bool isSilent(const int16 *buffer, int samples) {
+		for (int i = 0; i < samples; ++i) {
+			if (buffer[i])
+				return false;
+		}
+		return true;
+	}
+
+	/** The number of samples a tick decodes */
+	static int chunkSize(bool isStereo) {
+		return kRate * kChunkLength / 1000 * (isStereo ? 2 : 1);
+	}
+
+	/**
+	 * Read the wrapper to its end, in reads of the given size, running the
+	 * decoder often enough to keep up, and compare with the samples of the
+	 * plain stream.
+	 */
+	void checkStream(bool isStereo, int readSize) {
+		int16 *expected;
+		Common::ScopedPtr<Audio::AudioStream> stream(Audio::makeDecodeAheadAudioStream(
+			createSineStream<int16>(kRate, kSeconds, &expected, false, isStereo), kLookahead));
+		const int total = kRate * kSeconds * (isStereo ? 2 : 1);
+
+		int16 *buffer = new int16[readSize];
+		const int ticksPerRead = (readSize + chunkSize(isStereo) - 1) / chunkSize(isStereo);
+		int pos = 0;
+		while (!stream->endOfData()) {
+			const int samples = stream->readBuffer(buffer, readSize);
+			TS_ASSERT(pos + samples <= total);
+			if (pos + samples > total)
+				break;
+			TS_ASSERT(!memcmp(buffer, expected + pos, samples * sizeof(int16)));
+			pos += samples;
+
+			for (int i = 0; i < ticksPerRead; ++i)
+				_system->_timer->tick();
+		}
+
+		TS_ASSERT_EQUALS(pos, total);
+		TS_ASSERT(stream->endOfData());
+		TS_ASSERT(stream->endOfStream());
+
+		delete[] buffer;
+		delete[] expected;
+	}
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new DecodeAheadTestSystem();
+		g_system = _system;
+		Audio::initDecodeAheadStreams();
+	}
+
+	void tearDown() {
+		Audio::deinitDecodeAheadStreams();
+		delete _system;
+		g_system = _oldSystem;
+	}
+
+	void test_samples() {
+		checkStream(false, 512);
+		checkStream(true, 512);
+		checkStream(false, 1000);
+		checkStream(true, 3000);
+	}
+
+	void test_underrun() {
+		int16 *expected;
+		Common::ScopedPtr<Audio::AudioStream> stream(Audio::makeDecodeAheadAudioStream(
+			createSineStream<int16>(kRate, kSeconds, &expected, false, false), kLookahead));
+
+		// The buffer is filled up front. Reading past it does not decode on
+		// the reading thread, but fills up the read with silence.
+		const int buffered = kRate * kLookahead / 1000;
+		int16 *buffer = new int16[kRate];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, kRate), kRate);
+		TS_ASSERT(!memcmp(buffer, expected, buffered * sizeof(int16)));
+		TS_ASSERT(isSilent(buffer + buffered, kRate - buffered));
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, kRate), kRate);
+		TS_ASSERT(isSilent(buffer, kRate));
+		TS_ASSERT(!stream->endOfData());
+
+		// The next tick continues where the decoder left off
+		_system->_timer->tick();
+		const int samples = chunkSize(false);
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, samples), samples);
+		TS_ASSERT(!memcmp(buffer, expected + buffered, samples * sizeof(int16)));
+
+		delete[] buffer;
+		delete[] expected;
+	}
+
+	void test_seek() {
+		int16 *expected;
+		Common::ScopedPtr<Audio::SeekableAudioStream> stream(Audio::makeDecodeAheadAudioStream(
+			createSineStream<int16>(kRate, kSeconds, &expected, false, false), kLookahead));
+
+		int16 buffer[128];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, ARRAYSIZE(buffer)), (int)ARRAYSIZE(buffer));
+
+		// Seeking drops what was decoded before, and leaves the seek to the
+		// decoder. Until it ran, there is only silence.
+		TS_ASSERT(stream->seek(Audio::Timestamp(1000, kRate)));
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, ARRAYSIZE(buffer)), (int)ARRAYSIZE(buffer));
+		TS_ASSERT(isSilent(buffer, ARRAYSIZE(buffer)));
+		TS_ASSERT(!stream->endOfData());
+
+		_system->_timer->tick();
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, ARRAYSIZE(buffer)), (int)ARRAYSIZE(buffer));
+		TS_ASSERT(!memcmp(buffer, expected + kRate, sizeof(buffer)));
+		TS_ASSERT_EQUALS(stream->getLength().totalNumberOfFrames(), kRate * kSeconds);
+
+		// Seeking past the end fails
+		TS_ASSERT(!stream->seek(Audio::Timestamp(kSeconds * 1000 + 1, kRate)));
+
+		delete[] expected;
+	}
+
+	void test_delete() {
+		// Deleted streams must drop out of the timer callback's list
+		Audio::AudioStream *first = Audio::makeDecodeAheadAudioStream(createSineStream<int16>(kRate, kSeconds, nullptr, false, false), kLookahead);
+		Audio::AudioStream *second = Audio::makeDecodeAheadAudioStream(createSineStream<int16>(kRate, kSeconds, nullptr, false, true), kLookahead);
+		delete first;
+		_system->_timer->tick();
+		delete second;
+		_system->_timer->tick();
+	}
+};
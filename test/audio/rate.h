@@ -0,0 +1,238 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/array.h"
+#include "common/ptr.h"
+
+#include "test/benchmark.h"
+
+/**
+ * Audio stream producing a fixed amount of pseudo random samples, including
+ * the extreme sample values.
+ */
+class NoiseStream : public Audio::AudioStream {
+	bool _stereo;
+	int _rate;
+	int _left;
+	uint32 _seed;
+
+public:
+	NoiseStream(bool stereo, int rate, int samples) : _stereo(stereo), _rate(rate), _left(samples), _seed(1) {}
+
+	virtual int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = MIN(numSamples, _left);
+		for (int i = 0; i < samples; ++i) {
+			_seed = _seed * 1103515245 + 12345;
+			switch ((_seed >> 8) & 15) {
+			case 0:
+				buffer[i] = Audio::ST_SAMPLE_MAX;
+				break;
+			case 1:
+				buffer[i] = Audio::ST_SAMPLE_MIN;
+				break;
+			default:
+				buffer[i] = (int16)(_seed >> 16);
+			}
+		}
+		_left -= samples;
+		return samples;
+	}
+
+	virtual bool isStereo() const { return _stereo; }
+	virtual int getRate() const { return _rate; }
+	virtual bool endOfData() const { return _left == 0; }
+};
+
+/**
+ * Audio stream producing a sine wave.
+ */
+class ToneStream : public Audio::AudioStream {
+	int _rate;
+	int _frequency;
+	int _pos;
+	int _left;
+
+public:
+	ToneStream(int rate, int frequency, int samples) : _rate(rate), _frequency(frequency), _pos(0), _left(samples) {}
+
+	virtual int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = MIN(numSamples, _left);
+		for (int i = 0; i < samples; ++i, ++_pos)
+			buffer[i] = (int16)floor(16384 * sin(2 * M_PI * _frequency * _pos / _rate) + 0.5);
+		_left -= samples;
+		return samples;
+	}
+
+	virtual bool isStereo() const { return false; }
+	virtual int getRate() const { return _rate; }
+	virtual bool endOfData() const { return _left == 0; }
+};
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+	enum {
+		kOutputRate = 22050,
+		kInputSamples = 20000,
+		kChunkFrames = 333
+	};
+
+	/**
+	 * Run the converter over the whole input, in chunks of an odd size, and
+	 * return the output.
+	 */
+	Common::Array<int16> convert(int inRate, bool stereo, bool reverseStereo, bool highQuality, Audio::st_volume_t volL, Audio::st_volume_t volR, const Common::Array<int16> &initial) {
+		NoiseStream input(stereo, inRate, kInputSamples);
+		Common::ScopedPtr<Audio::RateConverter> converter(Audio::makeRateConverter(inRate, kOutputRate, stereo, reverseStereo, highQuality));
+
+		Common::Array<int16> output(initial);
+		uint32 pos = 0;
+		while (pos < output.size()) {
+			const uint32 frames = MIN<uint32>(kChunkFrames, (output.size() - pos) / 2);
+			const int written = converter->flow(input, &output[pos], frames, volL, volR);
+			pos += written * 2;
+			if (written < (int)frames)
+				break;
+		}
+		output.resize(pos);
+		return output;
+	}
+
+	void checkConverter(int inRate, bool stereo, bool reverseStereo, bool highQuality = false) {
+		const uint32 outSamples = (uint32)((uint64)kInputSamples * kOutputRate / inRate) * (stereo ? 1 : 2) + 64;
+
+		// At full volume mixing into silence yields the resampled input
+		Common::Array<int16> silence(outSamples, 0);
+		Common::Array<int16> resampled = convert(inRate, stereo, reverseStereo, highQuality, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume, silence);
+		TS_ASSERT(resampled.size() > outSamples / 2);
+
+		// Mixing into existing data must give the same result as the
+		// clampedAdd based code, including the rounding and clipping
+		static const Audio::st_volume_t volumes[][2] = { { 256, 256 }, { 173, 20 }, { 0, 255 }, { 1, 128 } };
+		for (uint v = 0; v < ARRAYSIZE(volumes); ++v) {
+			const Audio::st_volume_t volL = volumes[v][0];
+			const Audio::st_volume_t volR = volumes[v][1];
+
+			Common::Array<int16> initial(outSamples);
+			uint32 seed = 7;
+			for (uint32 i = 0; i < initial.size(); ++i) {
+				seed = seed * 1103515245 + 12345;
+				initial[i] = (int16)(seed >> 16);
+			}
+
+			Common::Array<int16> mixed = convert(inRate, stereo, reverseStereo, highQuality, volL, volR, initial);
+			TS_ASSERT_EQUALS(resampled.size(), mixed.size());
+			if (resampled.size() != mixed.size())
+				return;
+
+			for (uint32 i = 0; i < mixed.size(); ++i) {
+				int16 expected = initial[i];
+				const Audio::st_volume_t vol = ((i & 1) ^ reverseStereo) ? volR : volL;
+				Audio::clampedAdd(expected, (resampled[i] * (int)vol) / Audio::Mixer::kMaxMixerVolume);
+				if (expected != mixed[i]) {
+					TS_ASSERT_EQUALS(expected, mixed[i]);
+					return;
+				}
+			}
+		}
+	}
+
+public:
+	void test_copy() {
+		checkConverter(kOutputRate, false, false);
+		checkConverter(kOutputRate, true, false);
+		checkConverter(kOutputRate, true, true);
+	}
+
+	void test_simple() {
+		checkConverter(kOutputRate * 2, false, false);
+		checkConverter(kOutputRate * 2, true, false);
+		checkConverter(kOutputRate * 2, true, true);
+	}
+
+	void test_linear() {
+		checkConverter(11025, false, false);
+		checkConverter(11025, true, false);
+		checkConverter(32000, true, true);
+	}
+
+	void test_sinc() {
+		checkConverter(11025, false, false, true);
+		checkConverter(11025, true, false, true);
+		checkConverter(32000, true, true, true);
+		checkConverter(kOutputRate * 3, true, false, true);
+	}
+
+	void test_sinc_tone() {
+		enum {
+			kInputRate = 11025,
+			kFrequency = 3000,
+			kFrames = 4096
+		};
+
+		// Upsampling must reproduce the tone without the images linear
+		// interpolation leaves behind
+		ToneStream input(kInputRate, kFrequency, kFrames);
+		Common::ScopedPtr<Audio::RateConverter> converter(Audio::makeRateConverter(kInputRate, kOutputRate, false, false, true));
+		Common::Array<int16> output(kFrames * 2 * 2, 0);
+		const int written = converter->flow(input, &output[0], kFrames * 2, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		TS_ASSERT(written > kFrames * 2 - 64);
+
+		int maxError = 0;
+		for (int i = 64; i < written - 64; ++i) {
+			const int expected = (int)floor(16384 * sin(2 * M_PI * kFrequency * i / kOutputRate) + 0.5);
+			maxError = MAX(maxError, ABS(output[2 * i] - expected));
+			TS_ASSERT_EQUALS(output[2 * i], output[2 * i + 1]);
+		}
+		TS_ASSERT_LESS_THAN(maxError, 200);
+	}
+
+	/**
+	 * Micro-benchmark of the converters: mixes 32 channels into one buffer
+	 * and reports how much faster than real time that is. The sinc converter
+	 * is also measured at the output rates backends usually ask for.
+	 */
+	void test_benchmark() {
+		static const struct {
+			int inRate;
+			int outRate;
+			bool highQuality;
+			const char *name;
+		} cases[] = {
+			{ kOutputRate, kOutputRate, false, "copy" },
+			{ kOutputRate * 2, kOutputRate, false, "simple" },
+			{ 11025, kOutputRate, false, "linear" },
+			{ 11025, kOutputRate, true, "sinc upsampling" },
+			{ 32000, kOutputRate, true, "sinc downsampling" },
+			{ 22050, 44100, true, "sinc upsampling" },
+			{ 48000, 44100, true, "sinc downsampling" },
+			{ 22050, 48000, true, "sinc upsampling" },
+			{ 44100, 48000, true, "sinc upsampling" }
+		};
+		enum {
+			kChannels = 32,
+			kSeconds = 2
+		};
+
+		for (uint c = 0; c < ARRAYSIZE(cases); ++c) {
+			const int frames = cases[c].outRate * kSeconds;
+			Common::Array<int16> output(frames * 2, 0);
+
+			for (int stereo = 0; stereo < 2; ++stereo) {
+				const BenchmarkTimer timer;
+				for (int channel = 0; channel < kChannels; ++channel) {
+					NoiseStream input(stereo, cases[c].inRate, (cases[c].inRate * kSeconds + 64) * 2);
+					Common::ScopedPtr<Audio::RateConverter> converter(Audio::makeRateConverter(cases[c].inRate, cases[c].outRate, stereo, false, cases[c].highQuality));
+					converter->flow(input, &output[0], frames, 100, 200);
+				}
+				const double seconds = timer.seconds();
+
+				char buf[128];
+				snprintf(buf, sizeof(buf), "%s %s, %d to %d Hz: %d channels at %.1fx real time",
+				         cases[c].name, stereo ? "stereo" : "mono", cases[c].inRate, cases[c].outRate, (int)kChannels, kSeconds / seconds);
+				TS_TRACE(buf);
+			}
+		}
+	}
+};
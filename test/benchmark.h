@@ -0,0 +1,26 @@
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+// There is no OSystem in the test runner to take the time with
+#undef clock
+#include <time.h>
+
+/**
+ * Measures the processor time spent in a micro-benchmark.
+ */
+class BenchmarkTimer {
+	clock_t _start;
+
+public:
+	BenchmarkTimer() : _start(clock()) {}
+
+	void restart() { _start = clock(); }
+
+	/** Seconds spent since the timer was created or restarted, never 0. */
+	double seconds() const {
+		const double seconds = (double)(clock() - _start) / CLOCKS_PER_SEC;
+		return seconds > 1e-6 ? seconds : 1e-6;
+	}
+};
+
+#endif
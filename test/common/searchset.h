@@ -0,0 +1,170 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/str-array.h"
+
+/**
+ * Archive with a fixed set of (empty) members, which counts how often it
+ * gets asked for them.
+ */
+class CountingArchive : public Common::Archive {
+	Common::StringArray _names;
+
+public:
+	mutable int _probes;
+
+	CountingArchive() : _probes(0) {}
+
+	void addName(const Common::String &name) { _names.push_back(name); }
+
+	virtual bool hasFile(const Common::String &name) const {
+		++_probes;
+		for (uint i = 0; i < _names.size(); ++i) {
+			if (_names[i].equalsIgnoreCase(name))
+				return true;
+		}
+		return false;
+	}
+
+	virtual int listMembers(Common::ArchiveMemberList &list) const {
+		for (uint i = 0; i < _names.size(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_names[i], this)));
+		return _names.size();
+	}
+
+	virtual const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return Common::ArchiveMemberPtr();
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+	}
+
+	virtual Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return nullptr;
+		return new Common::MemoryReadStream((const byte *)this, 0);
+	}
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+public:
+	void test_lookup_cache() {
+		Common::SearchSet set;
+		CountingArchive *high = new CountingArchive();
+		CountingArchive *low = new CountingArchive();
+		high->addName("a.dat");
+		low->addName("a.dat");
+		low->addName("b.dat");
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT(set.hasFile("b.dat"));
+		TS_ASSERT(!set.hasFile("c.dat"));
+		const int highProbes = high->_probes;
+		const int lowProbes = low->_probes;
+
+		// Repeated lookups, including misses, are answered from the cache
+		for (int i = 0; i < 10; ++i) {
+			TS_ASSERT(set.hasFile("a.dat"));
+			TS_ASSERT(set.hasFile("b.dat"));
+			TS_ASSERT(!set.hasFile("c.dat"));
+		}
+		TS_ASSERT_EQUALS(highProbes, high->_probes);
+		TS_ASSERT_EQUALS(lowProbes, low->_probes);
+
+		// The member comes from the archive with the highest priority
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("a.dat");
+		TS_ASSERT(stream);
+		delete stream;
+		TS_ASSERT_EQUALS(highProbes + 1, high->_probes);
+		TS_ASSERT_EQUALS(lowProbes, low->_probes);
+
+		TS_ASSERT(!set.createReadStreamForMember("c.dat"));
+		TS_ASSERT_EQUALS(lowProbes, low->_probes);
+	}
+
+	void test_lookup_cache_ignores_case() {
+		Common::SearchSet set;
+		CountingArchive *archive = new CountingArchive();
+		archive->addName("a.dat");
+		set.add("archive", archive);
+
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT(!set.hasFile("c.dat"));
+		const int probes = archive->_probes;
+
+		// Hits and misses are shared by all spellings of a name
+		TS_ASSERT(set.hasFile("A.DAT"));
+		TS_ASSERT(set.hasFile("A.dat"));
+		TS_ASSERT(!set.hasFile("C.DAT"));
+		TS_ASSERT_EQUALS(probes, archive->_probes);
+	}
+
+	void test_invalidation() {
+		Common::SearchSet set;
+		CountingArchive *first = new CountingArchive();
+		first->addName("a.dat");
+		set.add("first", first);
+
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT(!set.hasFile("b.dat"));
+
+		CountingArchive *second = new CountingArchive();
+		second->addName("b.dat");
+		set.add("second", second);
+		TS_ASSERT(set.hasFile("b.dat"));
+
+		set.remove("second");
+		TS_ASSERT(!set.hasFile("b.dat"));
+
+		set.remove("first");
+		TS_ASSERT(!set.hasFile("a.dat"));
+		TS_ASSERT(!set.createReadStreamForMember("a.dat"));
+	}
+
+	void test_nested_invalidation() {
+		Common::SearchSet outer, inner;
+		outer.add("inner", &inner, 0, false);
+
+		TS_ASSERT(!outer.hasFile("a.dat"));
+
+		// Modifying the contained set must not leave stale results behind
+		// in the outer one
+		CountingArchive *archive = new CountingArchive();
+		archive->addName("a.dat");
+		inner.add("archive", archive);
+		TS_ASSERT(outer.hasFile("a.dat"));
+
+		inner.remove("archive");
+		TS_ASSERT(!outer.hasFile("a.dat"));
+
+		outer.remove("inner");
+	}
+
+	void test_nested_lifetime() {
+		Common::SearchSet outer, other;
+		CountingArchive *archive = new CountingArchive();
+		archive->addName("b.dat");
+		other.add("archive", archive);
+		TS_ASSERT(!other.hasFile("a.dat"));
+
+		// Modifying a contained set only invalidates the sets containing it
+		Common::SearchSet *inner = new Common::SearchSet();
+		outer.add("inner", inner, 0, false);
+		inner->add("a", new CountingArchive());
+		const int probes = archive->_probes;
+		TS_ASSERT(!other.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(probes, archive->_probes);
+
+		// A contained set drops out of the sets containing it when it is
+		// deleted
+		CountingArchive *found = new CountingArchive();
+		found->addName("a.dat");
+		inner->add("found", found);
+		TS_ASSERT(outer.hasFile("a.dat"));
+		delete inner;
+		TS_ASSERT(!outer.hasArchive("inner"));
+		TS_ASSERT(!outer.hasFile("a.dat"));
+	}
+};
@@ -0,0 +1,281 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+#include "backends/fs/abstract-fs.h"
+
+/**
+ * A file node whose contents live in memory. Every stream opened on it gets
+ * its own copy of the data, just like every stream opened on a real file has
+ * its own file handle.
+ */
+class MemoryFSNode : public AbstractFSNode {
+	Common::String _name;
+	Common::Array<byte> _data;
+
+public:
+	MemoryFSNode(const Common::String &name, Common::SeekableReadStream &stream) : _name(name), _data(stream.size()) {
+		stream.seek(0);
+		stream.read(_data.begin(), _data.size());
+	}
+
+	virtual bool exists() const { return true; }
+	virtual bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const { return false; }
+	virtual Common::String getName() const { return _name; }
+	virtual Common::String getPath() const { return _name; }
+	virtual bool isDirectory() const { return false; }
+	virtual bool isReadable() const { return true; }
+	virtual bool isWritable() const { return false; }
+	virtual AbstractFSNode *getChild(const Common::String &name) const { return nullptr; }
+	virtual AbstractFSNode *getParent() const { return nullptr; }
+	virtual Common::WriteStream *createWriteStream() { return nullptr; }
+	virtual bool createDirectory() { return false; }
+
+	virtual Common::SeekableReadStream *createReadStream() {
+		byte *copy = (byte *)malloc(_data.size());
+		memcpy(copy, _data.begin(), _data.size());
+		return new Common::MemoryReadStream(copy, _data.size(), DisposeAfterUse::YES);
+	}
+};
+
+/**
+ * Builds a ZIP archive in memory. Deflated members are produced by stripping
+ * the gzip header and trailer from the output of a compressed write stream.
+ */
+class ZipBuilder {
+	struct Entry {
+		Common::String name;
+		uint32 offset;
+		uint16 method;
+		uint32 crc;
+		uint32 compressedSize;
+		uint32 uncompressedSize;
+	};
+
+	Common::MemoryWriteStreamDynamic _zip;
+	Common::Array<Entry> _entries;
+
+public:
+	ZipBuilder() : _zip(DisposeAfterUse::NO) {}
+
+	bool addFile(const Common::String &name, const byte *data, uint32 size, bool compress) {
+		Entry entry;
+		entry.name = name;
+		entry.offset = _zip.pos();
+		entry.uncompressedSize = size;
+
+		// The compressed stream takes ownership of the memory stream
+		Common::MemoryWriteStreamDynamic *gzip = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *compressor = Common::wrapCompressedWriteStream(gzip);
+		if (compressor == gzip) {
+			delete gzip;
+			return false;
+		}
+		compressor->write(data, size);
+		compressor->finalize();
+
+		const byte *gzipData = gzip->getData();
+		const uint32 gzipSize = gzip->size();
+		entry.crc = READ_LE_UINT32(gzipData + gzipSize - 8);
+
+		// Skip the 10 byte gzip header and the 8 byte trailer
+		const byte *payload = compress ? gzipData + 10 : data;
+		entry.compressedSize = compress ? gzipSize - 18 : size;
+		entry.method = compress ? 8 : 0;
+
+		_zip.writeUint32LE(0x04034b50);
+		_zip.writeUint16LE(20);
+		_zip.writeUint16LE(0);
+		_zip.writeUint16LE(entry.method);
+		_zip.writeUint32LE(0);
+		_zip.writeUint32LE(entry.crc);
+		_zip.writeUint32LE(entry.compressedSize);
+		_zip.writeUint32LE(entry.uncompressedSize);
+		_zip.writeUint16LE(name.size());
+		_zip.writeUint16LE(0);
+		_zip.write(name.c_str(), name.size());
+		_zip.write(payload, entry.compressedSize);
+
+		delete compressor;
+		_entries.push_back(entry);
+		return true;
+	}
+
+	Common::SeekableReadStream *finish() {
+		const uint32 centralStart = _zip.pos();
+		for (uint i = 0; i < _entries.size(); ++i) {
+			const Entry &entry = _entries[i];
+			_zip.writeUint32LE(0x02014b50);
+			_zip.writeUint16LE(20);
+			_zip.writeUint16LE(20);
+			_zip.writeUint16LE(0);
+			_zip.writeUint16LE(entry.method);
+			_zip.writeUint32LE(0);
+			_zip.writeUint32LE(entry.crc);
+			_zip.writeUint32LE(entry.compressedSize);
+			_zip.writeUint32LE(entry.uncompressedSize);
+			_zip.writeUint16LE(entry.name.size());
+			_zip.writeUint16LE(0);
+			_zip.writeUint16LE(0);
+			_zip.writeUint16LE(0);
+			_zip.writeUint16LE(0);
+			_zip.writeUint32LE(0);
+			_zip.writeUint32LE(entry.offset);
+			_zip.write(entry.name.c_str(), entry.name.size());
+		}
+		const uint32 centralSize = _zip.pos() - centralStart;
+
+		_zip.writeUint32LE(0x06054b50);
+		_zip.writeUint16LE(0);
+		_zip.writeUint16LE(0);
+		_zip.writeUint16LE(_entries.size());
+		_zip.writeUint16LE(_entries.size());
+		_zip.writeUint32LE(centralSize);
+		_zip.writeUint32LE(centralStart);
+		_zip.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(_zip.getData(), _zip.size(), DisposeAfterUse::YES);
+	}
+};
+
+class ZipTestSuite : public CxxTest::TestSuite {
+	enum {
+		// Large enough to be streamed and to get a few inflate checkpoints
+		kLargeSize = 3 * 1024 * 1024 + 123,
+		kSmallSize = 1000
+	};
+
+	Common::Array<byte> _data;
+
+	/**
+	 * Build the test archive. Archives opened from a file stream their
+	 * large members, archives opened from a stream extract every member.
+	 */
+	Common::Archive *makeArchive(bool fromFile) {
+		_data.resize(kLargeSize);
+		uint32 seed = 1;
+		for (uint32 i = 0; i < kLargeSize; ++i) {
+			seed = seed * 1103515245 + 12345;
+			// Keep the data compressible, but not trivially so
+			_data[i] = (i & 0x100) ? (byte)(seed >> 16) & 0x0f : (byte)i;
+		}
+
+		ZipBuilder builder;
+		if (!builder.addFile("large.bin", _data.begin(), kLargeSize, true) ||
+		    !builder.addFile("Stored.bin", _data.begin(), kLargeSize, false) ||
+		    !builder.addFile("small.bin", _data.begin(), kSmallSize, true))
+			return nullptr;
+
+		Common::SeekableReadStream *zip = builder.finish();
+		if (!fromFile)
+			return Common::makeZipArchive(zip);
+
+		Common::FSNode node = AbstractFSNode::makeFSNode(new MemoryFSNode("test.zip", *zip));
+		delete zip;
+		return Common::makeZipArchive(node);
+	}
+
+	void checkRange(Common::SeekableReadStream &stream, uint32 start, uint32 len) {
+		Common::Array<byte> buffer(len);
+		TS_ASSERT(stream.seek(start));
+		TS_ASSERT_EQUALS((int32)start, stream.pos());
+		TS_ASSERT_EQUALS(len, stream.read(buffer.begin(), len));
+		TS_ASSERT(!memcmp(buffer.begin(), _data.begin() + start, len));
+		TS_ASSERT(!stream.err());
+	}
+
+	void checkMember(Common::Archive &archive, const char *name, uint32 size, bool streamed) {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive.createReadStreamForMember(name));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		TS_ASSERT_EQUALS((int32)size, stream->size());
+
+		// Sequential read of the whole member
+		checkRange(*stream, 0, size);
+
+		byte b;
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(0u, stream->read(&b, 1));
+		TS_ASSERT(stream->eos());
+
+		// Backward and forward seeks, across checkpoint boundaries
+		checkRange(*stream, size / 2, 100);
+		checkRange(*stream, 10, size / 4);
+		checkRange(*stream, size - 50, 50);
+		checkRange(*stream, size / 3, size / 3);
+		checkRange(*stream, 0, 1);
+
+		TS_ASSERT(stream->seek(-1, SEEK_END));
+		TS_ASSERT_EQUALS(1u, stream->read(&b, 1));
+		TS_ASSERT_EQUALS(_data[size - 1], b);
+
+		// Memory streams assert on this instead
+		if (streamed)
+			TS_ASSERT(!stream->seek(size + 1));
+	}
+
+	void checkIndependentStreams(bool fromFile) {
+		Common::ScopedPtr<Common::Archive> archive(makeArchive(fromFile));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::ScopedPtr<Common::SeekableReadStream> first(archive->createReadStreamForMember("large.bin"));
+		Common::ScopedPtr<Common::SeekableReadStream> second(archive->createReadStreamForMember("stored.bin"));
+		TS_ASSERT(first && second);
+		if (!first || !second)
+			return;
+
+		// Interleaved reads must not disturb each other, and the streams
+		// remain usable after the archive is gone
+		for (uint32 i = 0; i < 64; ++i) {
+			byte a[512], b[512];
+			TS_ASSERT_EQUALS(sizeof(a), first->read(a, sizeof(a)));
+			TS_ASSERT_EQUALS(sizeof(b), second->read(b, sizeof(b)));
+			TS_ASSERT(!memcmp(a, b, sizeof(a)));
+			TS_ASSERT(!memcmp(a, _data.begin() + i * sizeof(a), sizeof(a)));
+
+			if (i == 32)
+				archive.reset();
+		}
+	}
+
+public:
+	void test_members() {
+#ifndef USE_ZLIB
+		// Deflated members can neither be created nor read without zlib
+		return;
+#endif
+		for (int fromFile = 0; fromFile < 2; ++fromFile) {
+			Common::ScopedPtr<Common::Archive> archive(makeArchive(fromFile));
+			TS_ASSERT(archive);
+			if (!archive)
+				return;
+
+			TS_ASSERT(archive->hasFile("LARGE.BIN"));
+			TS_ASSERT(archive->hasFile("stored.bin"));
+			TS_ASSERT(!archive->hasFile("missing.bin"));
+			TS_ASSERT(!archive->createReadStreamForMember("missing.bin"));
+
+			checkMember(*archive, "large.bin", kLargeSize, fromFile);
+			checkMember(*archive, "stored.bin", kLargeSize, fromFile);
+			checkMember(*archive, "small.bin", kSmallSize, false);
+		}
+	}
+
+	void test_independent_streams() {
+#ifndef USE_ZLIB
+		// Deflated members can neither be created nor read without zlib
+		return;
+#endif
+		for (int fromFile = 0; fromFile < 2; ++fromFile)
+			checkIndependentStreams(fromFile);
+	}
+};
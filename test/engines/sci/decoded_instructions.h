@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+
+#include "engines/sci/engine/script.h"
+
+class DecodedInstructionsTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	/**
+	 * Decodes like readPMachineInstruction(), with a fixed opcode format
+	 * table, since the real one needs a running game: each opcode has up to
+	 * three operands, which are bytes if the low bit of the opcode is set
+	 * and words otherwise.
+	 */
+	static int decode(const byte *src, byte &extOpcode, int16 opparams[4]) {
+		int offset = 0;
+		extOpcode = src[offset++];
+		memset(opparams, 0, 4 * sizeof(int16));
+
+		const int operandCount = (extOpcode >> 1) % 4;
+		for (int i = 0; i < operandCount; ++i) {
+			if (extOpcode & 1) {
+				opparams[i] = (int8)src[offset++];
+			} else {
+				opparams[i] = (int16)READ_LE_UINT16(src + offset);
+				offset += 2;
+			}
+		}
+		return offset;
+	}
+
+	/** Fills the buffer with instructions and returns their offsets */
+	Common::Array<uint32> generateCode(Common::Array<byte> &buf, uint32 size) {
+		Common::Array<uint32> starts;
+		buf.resize(size + 8);
+		for (uint32 i = 0; i < buf.size(); ++i)
+			buf[i] = nextRandom(256);
+
+		byte extOpcode;
+		int16 opparams[4];
+		for (uint32 offset = 0; offset < size; offset += decode(&buf[offset], extOpcode, opparams))
+			starts.push_back(offset);
+		return starts;
+	}
+
+	/** Decodes through the table, like Script::decodeInstruction() */
+	int decodeCached(Sci::DecodedInstructionTable &table, const Common::Array<byte> &buf, uint32 offset, byte &extOpcode, int16 opparams[4]) {
+		const Sci::DecodedInstruction *instruction = table.find(offset);
+		if (instruction) {
+			extOpcode = instruction->extOpcode;
+			memcpy(opparams, instruction->opparams, sizeof(instruction->opparams));
+			return instruction->size;
+		}
+
+		Sci::DecodedInstruction decoded;
+		decoded.size = decode(&buf[offset], decoded.extOpcode, decoded.opparams);
+		TS_ASSERT(table.add(offset, buf.size(), decoded));
+		extOpcode = decoded.extOpcode;
+		memcpy(opparams, decoded.opparams, sizeof(decoded.opparams));
+		return decoded.size;
+	}
+
+public:
+	void test_replay() {
+		_seed = 7;
+		for (int run = 0; run < 20; ++run) {
+			Common::Array<byte> buf;
+			const Common::Array<uint32> starts = generateCode(buf, 1 + nextRandom(3000));
+			Sci::DecodedInstructionTable table;
+			Common::Array<bool> decoded(starts.size());
+
+			// Run stretches of code starting at random instructions, as
+			// calls and branches do, and compare each instruction against
+			// a fresh decode
+			for (int jump = 0; jump < 200; ++jump) {
+				uint index = nextRandom(starts.size());
+				for (uint count = nextRandom(40); count && index < starts.size(); --count, ++index) {
+					byte extOpcode, refExtOpcode;
+					int16 opparams[4], refOpparams[4];
+					const int size = decodeCached(table, buf, starts[index], extOpcode, opparams);
+					const int refSize = decode(&buf[starts[index]], refExtOpcode, refOpparams);
+					TS_ASSERT_EQUALS(size, refSize);
+					TS_ASSERT_EQUALS(extOpcode, refExtOpcode);
+					TS_ASSERT_SAME_DATA(opparams, refOpparams, sizeof(opparams));
+					TS_ASSERT_EQUALS((uint32)starts[index] + size, index + 1 < starts.size() ? starts[index + 1] : starts[index] + refSize);
+					decoded[index] = true;
+				}
+			}
+
+			// Only the instructions which ran are in the table, and nothing
+			// is found in between them
+			uint decodedCount = 0;
+			for (uint i = 0; i < starts.size(); ++i) {
+				if (decoded[i])
+					++decodedCount;
+				const Sci::DecodedInstruction *instruction = table.find(starts[i]);
+				TS_ASSERT_EQUALS(instruction != NULL, (bool)decoded[i]);
+				if (instruction) {
+					byte refExtOpcode;
+					int16 refOpparams[4];
+					TS_ASSERT_EQUALS((int)instruction->size, decode(&buf[starts[i]], refExtOpcode, refOpparams));
+					TS_ASSERT_EQUALS(instruction->extOpcode, refExtOpcode);
+				}
+
+				const uint32 end = i + 1 < starts.size() ? starts[i + 1] : buf.size();
+				for (uint32 offset = starts[i] + 1; offset < end; ++offset)
+					TS_ASSERT(!table.find(offset));
+			}
+			TS_ASSERT_EQUALS(table.size(), decodedCount);
+			TS_ASSERT(!table.find(buf.size() + 100));
+		}
+	}
+
+	void test_full() {
+		Common::Array<byte> buf(Sci::DecodedInstructionTable::kMaxInstructions + 100);
+		Sci::DecodedInstructionTable table;
+		Sci::DecodedInstruction instruction;
+		memset(&instruction, 0, sizeof(instruction));
+		instruction.size = 1;
+
+		for (uint32 offset = 0; offset < Sci::DecodedInstructionTable::kMaxInstructions; ++offset) {
+			instruction.extOpcode = offset & 0xFF;
+			TS_ASSERT(table.add(offset, buf.size(), instruction));
+		}
+		TS_ASSERT(!table.add(Sci::DecodedInstructionTable::kMaxInstructions, buf.size(), instruction));
+		TS_ASSERT(!table.find(Sci::DecodedInstructionTable::kMaxInstructions));
+		TS_ASSERT_EQUALS(table.find(1000)->extOpcode, 1000 & 0xFF);
+
+		table.clear();
+		TS_ASSERT(!table.find(1000));
+		TS_ASSERT_EQUALS(table.size(), 0u);
+	}
+};
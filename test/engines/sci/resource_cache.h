@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+
+#include "engines/sci/resource.h"
+
+/**
+ * A resource which only has a size, to feed the LRU cache
+ */
+class CacheTestResource : public Sci::Resource {
+public:
+	CacheTestResource(Sci::ResourceManager *resMan, Sci::ResourceType type, uint16 number, uint32 size) :
+		Resource(resMan, Sci::ResourceId(type, number)) {
+		_size = size;
+	}
+
+	void load() {
+		_data = new byte[_size];
+		_status = Sci::kResStatusAllocated;
+	}
+
+	bool isLoaded() const { return _data != nullptr; }
+};
+
+/**
+ * Exposes the LRU cache of the resource manager, without any game
+ */
+class CacheTestResourceManager : public Sci::ResourceManager {
+public:
+	CacheTestResourceManager(int maxMemory) : ResourceManager(true) {
+		_maxMemoryLRU = maxMemory;
+		_memoryLocked = 0;
+		for (int i = 0; i < kLRUSegmentCount; ++i)
+			_memoryLRU[i] = 0;
+		resetCacheStatistics();
+	}
+
+	/** Loads the resource and hands it to the cache, like unlockResource does */
+	void release(CacheTestResource *res) {
+		res->load();
+		addToLRU(res);
+		freeOldResources();
+	}
+
+	int getTotalLRUMemory() const {
+		return getLRUMemory(kLRUSegmentSmall) + getLRUMemory(kLRUSegmentLarge);
+	}
+};
+
+class ResourceCacheTestSuite : public CxxTest::TestSuite {
+	enum {
+		kMaxMemory = 64 * 1024
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_total_within_budget() {
+		CacheTestResourceManager resMan(kMaxMemory);
+		Common::Array<CacheTestResource *> resources;
+
+		for (int i = 0; i < 500; ++i) {
+			CacheTestResource *res;
+			if (nextRandom(3))
+				res = new CacheTestResource(&resMan, Sci::kResourceTypeView, i, 1 + nextRandom(kMaxMemory / 20));
+			else
+				res = new CacheTestResource(&resMan, Sci::kResourceTypeAudio, i, 1 + nextRandom(kMaxMemory / 2));
+			resources.push_back(res);
+
+			resMan.release(res);
+			TS_ASSERT_LESS_THAN_EQUALS(resMan.getTotalLRUMemory(), kMaxMemory);
+		}
+
+		// What is cached is accounted for
+		int loaded = 0;
+		for (uint i = 0; i < resources.size(); ++i) {
+			if (resources[i]->isLoaded())
+				loaded += resources[i]->size();
+		}
+		TS_ASSERT_EQUALS(loaded, resMan.getTotalLRUMemory());
+
+		for (uint i = 0; i < resources.size(); ++i)
+			delete resources[i];
+	}
+
+	void test_large_resources_keep_to_their_share() {
+		CacheTestResourceManager resMan(kMaxMemory);
+		Common::Array<CacheTestResource *> views;
+		Common::Array<CacheTestResource *> clips;
+
+		// Small resources may use the whole budget while nothing else is cached
+		for (int i = 0; i < 16; ++i) {
+			views.push_back(new CacheTestResource(&resMan, Sci::kResourceTypeView, i, kMaxMemory / 16));
+			resMan.release(views.back());
+		}
+		TS_ASSERT_EQUALS(resMan.getTotalLRUMemory(), kMaxMemory);
+
+		// Speech clips then only push out what exceeds the share of the views
+		for (int i = 0; i < 10; ++i) {
+			clips.push_back(new CacheTestResource(&resMan, Sci::kResourceTypeAudio, i, kMaxMemory / 8));
+			resMan.release(clips.back());
+			TS_ASSERT_LESS_THAN_EQUALS(resMan.getTotalLRUMemory(), kMaxMemory);
+		}
+		TS_ASSERT_EQUALS(resMan.getLRUMemory(Sci::ResourceManager::kLRUSegmentSmall),
+		                 resMan.getLRUShare(Sci::ResourceManager::kLRUSegmentSmall));
+		TS_ASSERT_EQUALS(resMan.getLRUMemory(Sci::ResourceManager::kLRUSegmentLarge),
+		                 resMan.getLRUShare(Sci::ResourceManager::kLRUSegmentLarge));
+
+		// The most recently used ones stay
+		TS_ASSERT(views.back()->isLoaded());
+		TS_ASSERT(!views.front()->isLoaded());
+		TS_ASSERT(clips.back()->isLoaded());
+		TS_ASSERT(!clips.front()->isLoaded());
+
+		for (uint i = 0; i < views.size(); ++i)
+			delete views[i];
+		for (uint i = 0; i < clips.size(); ++i)
+			delete clips[i];
+	}
+};
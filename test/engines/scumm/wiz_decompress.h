@@ -0,0 +1,478 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/rect.h"
+
+#include "engines/scumm/he/wiz_he.h"
+
+/**
+ * Compares the Wiz decompressors with the per-pixel decompressors they
+ * replaced, on compressed sample images drawn with clipping, mirroring and
+ * all drawing types.
+ */
+class WizDecompressTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 150,
+		kHeight = 40,
+		kPadding = 3,
+		kTransColor = 5
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	void fill(Common::Array<byte> &data) {
+		for (uint i = 0; i < data.size(); ++i)
+			data[i] = nextRandom(256);
+	}
+
+	/**
+	 * A sprite with transparent margins around an ellipse, holding long and
+	 * short runs of a color, noise and transparent lines and holes, so that
+	 * every kind of code and the length limits of the compression show up.
+	 */
+	uint16 samplePixel(int x, int y) {
+		const int dx = 2 * x - kWidth, dy = (2 * y - kHeight) * kWidth / kHeight;
+		if (dx * dx + dy * dy > kWidth * kWidth || y == kHeight / 2 || (y % 7 == 3 && x % 23 < 4))
+			return kTransColor;
+		if (y % 5 == 0 || (x / 16) % 6 == 1)
+			return 17 + y % 3;
+		if ((x + y) % 11 == 0)
+			return nextRandom(2) ? 200 : 201;
+		uint16 color = nextRandom(256);
+		return color == kTransColor ? color + 1 : color;
+	}
+
+	/** Encodes the image the way the engine captures Wiz images */
+	void encode8(const Common::Array<byte> &pixels, Common::Array<byte> &data) {
+		const Common::Rect r(kWidth, kHeight);
+		data.resize(Scumm::Wiz::wizPackType1(nullptr, &pixels[0], kWidth, r, kTransColor));
+		Scumm::Wiz::wizPackType1(&data[0], &pixels[0], kWidth, r, kTransColor);
+	}
+
+	/** Encodes a 16-bit image line by line, in runs of at most 64 pixels */
+	static void encode16(const Common::Array<uint16> &pixels, Common::Array<byte> &data) {
+		for (int y = 0; y < kHeight; ++y) {
+			const uint16 *line = &pixels[y * kWidth];
+			const uint lineStart = data.size();
+			data.resize(lineStart + 2);
+
+			int x = 0;
+			while (x < kWidth) {
+				int count = 1;
+				while (x + count < kWidth && count < 0x40 && line[x + count] == line[x])
+					++count;
+
+				if (line[x] == kTransColor) {
+					data.push_back((count << 1) | 1);
+				} else if (count > 1) {
+					data.push_back(((count - 1) << 2) | 2);
+					data.push_back(line[x] & 0xFF);
+					data.push_back(line[x] >> 8);
+				} else {
+					// Literal pixels, until the next run
+					while (x + count < kWidth && count < 0x40 && line[x + count] != kTransColor &&
+					       (x + count + 1 >= kWidth || line[x + count + 1] != line[x + count]))
+						++count;
+					data.push_back(((count - 1) << 2) | 0);
+					for (int i = 0; i < count; ++i) {
+						data.push_back(line[x + i] & 0xFF);
+						data.push_back(line[x + i] >> 8);
+					}
+				}
+				x += count;
+			}
+
+			WRITE_LE_UINT16(&data[lineStart], data.size() - lineStart - 2);
+		}
+	}
+
+	/** Wiz::write8BitColor as the decompressors used it for every pixel */
+	template<int type>
+	static void oldWrite8BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+		if (bitDepth == 2) {
+			if (type == Scumm::kWizXMap) {
+				uint16 color = READ_LE_UINT16(palPtr + *dataPtr * 2);
+				uint16 srcColor = (color >> 1) & 0x7DEF;
+				uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
+				uint16 newColor = srcColor + dstColor;
+				Scumm::Wiz::writeColor(dstPtr, dstType, newColor);
+			}
+			if (type == Scumm::kWizRMap) {
+				Scumm::Wiz::writeColor(dstPtr, dstType, READ_LE_UINT16(palPtr + *dataPtr * 2));
+			}
+			if (type == Scumm::kWizCopy) {
+				Scumm::Wiz::writeColor(dstPtr, dstType, *dataPtr);
+			}
+		} else {
+			if (type == Scumm::kWizXMap) {
+				*dstPtr = xmapPtr[*dataPtr * 256 + *dstPtr];
+			}
+			if (type == Scumm::kWizRMap) {
+				*dstPtr = palPtr[*dataPtr];
+			}
+			if (type == Scumm::kWizCopy) {
+				*dstPtr = *dataPtr;
+			}
+		}
+	}
+
+	/** Wiz::decompressWizImage before it drew whole runs at once */
+	template<int type>
+	static void oldDecompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+		const uint8 *dataPtr, *dataPtrNext;
+		uint8 code, *dstPtr, *dstPtrNext;
+		int h, w, xoff, dstInc;
+
+		dstPtr = dst;
+		dataPtr = src;
+
+		// Skip over the first 'srcRect->top' lines in the data
+		h = srcRect.top;
+		while (h--) {
+			dataPtr += READ_LE_UINT16(dataPtr) + 2;
+		}
+		h = srcRect.height();
+		w = srcRect.width();
+		if (h <= 0 || w <= 0)
+			return;
+
+		if (flags & Scumm::kWIFFlipY) {
+			dstPtr += (h - 1) * dstPitch;
+			dstPitch = -dstPitch;
+		}
+		dstInc = bitDepth;
+		if (flags & Scumm::kWIFFlipX) {
+			dstPtr += (w - 1) * bitDepth;
+			dstInc = -bitDepth;
+		}
+
+		while (h--) {
+			xoff = srcRect.left;
+			w = srcRect.width();
+			uint16 lineSize = READ_LE_UINT16(dataPtr); dataPtr += 2;
+			dstPtrNext = dstPtr + dstPitch;
+			dataPtrNext = dataPtr + lineSize;
+			if (lineSize != 0) {
+				while (w > 0) {
+					code = *dataPtr++;
+					if (code & 1) {
+						code >>= 1;
+						if (xoff > 0) {
+							xoff -= code;
+							if (xoff >= 0)
+								continue;
+
+							code = -xoff;
+						}
+						dstPtr += dstInc * code;
+						w -= code;
+					} else if (code & 2) {
+						code = (code >> 2) + 1;
+						if (xoff > 0) {
+							xoff -= code;
+							++dataPtr;
+							if (xoff >= 0)
+								continue;
+
+							code = -xoff;
+							--dataPtr;
+						}
+						w -= code;
+						if (w < 0) {
+							code += w;
+						}
+						while (code--) {
+							oldWrite8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
+							dstPtr += dstInc;
+						}
+						dataPtr++;
+					} else {
+						code = (code >> 2) + 1;
+						if (xoff > 0) {
+							xoff -= code;
+							dataPtr += code;
+							if (xoff >= 0)
+								continue;
+
+							code = -xoff;
+							dataPtr += xoff;
+						}
+						w -= code;
+						if (w < 0) {
+							code += w;
+						}
+						while (code--) {
+							oldWrite8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
+							dataPtr++;
+							dstPtr += dstInc;
+						}
+					}
+				}
+			}
+			dataPtr = dataPtrNext;
+			dstPtr = dstPtrNext;
+		}
+	}
+
+#ifdef USE_RGB_COLOR
+	/** Wiz::write16BitColor as the decompressor used it for every pixel */
+	template<int type>
+	static void oldWrite16BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const uint8 *xmapPtr) {
+		uint16 col = READ_LE_UINT16(dataPtr);
+		if (type == Scumm::kWizXMap) {
+			uint16 srcColor = (col >> 1) & 0x7DEF;
+			uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
+			uint16 newColor = srcColor + dstColor;
+			Scumm::Wiz::writeColor(dstPtr, dstType, newColor);
+		}
+		if (type == Scumm::kWizCopy) {
+			Scumm::Wiz::writeColor(dstPtr, dstType, col);
+		}
+	}
+
+	/** Wiz::decompress16BitWizImage before it drew whole runs at once */
+	template<int type>
+	static void oldDecompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr) {
+		const uint8 *dataPtr, *dataPtrNext;
+		uint8 code;
+		uint8 *dstPtr, *dstPtrNext;
+		int h, w, xoff, dstInc;
+
+		dstPtr = dst;
+		dataPtr = src;
+
+		// Skip over the first 'srcRect->top' lines in the data
+		h = srcRect.top;
+		while (h--) {
+			dataPtr += READ_LE_UINT16(dataPtr) + 2;
+		}
+		h = srcRect.height();
+		w = srcRect.width();
+		if (h <= 0 || w <= 0)
+			return;
+
+		if (flags & Scumm::kWIFFlipY) {
+			dstPtr += (h - 1) * dstPitch;
+			dstPitch = -dstPitch;
+		}
+		dstInc = 2;
+		if (flags & Scumm::kWIFFlipX) {
+			dstPtr += (w - 1) * 2;
+			dstInc = -2;
+		}
+
+		while (h--) {
+			xoff = srcRect.left;
+			w = srcRect.width();
+			uint16 lineSize = READ_LE_UINT16(dataPtr); dataPtr += 2;
+			dstPtrNext = dstPtr + dstPitch;
+			dataPtrNext = dataPtr + lineSize;
+			if (lineSize != 0) {
+				while (w > 0) {
+					code = *dataPtr++;
+					if (code & 1) {
+						code >>= 1;
+						if (xoff > 0) {
+							xoff -= code;
+							if (xoff >= 0)
+								continue;
+
+							code = -xoff;
+						}
+						dstPtr += dstInc * code;
+						w -= code;
+					} else if (code & 2) {
+						code = (code >> 2) + 1;
+						if (xoff > 0) {
+							xoff -= code;
+							dataPtr += 2;
+							if (xoff >= 0)
+								continue;
+
+							code = -xoff;
+							dataPtr -= 2;
+						}
+						w -= code;
+						if (w < 0) {
+							code += w;
+						}
+						while (code--) {
+							oldWrite16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
+							dstPtr += dstInc;
+						}
+						dataPtr += 2;
+					} else {
+						code = (code >> 2) + 1;
+						if (xoff > 0) {
+							xoff -= code;
+							dataPtr += code * 2;
+							if (xoff >= 0)
+								continue;
+
+							code = -xoff;
+							dataPtr += xoff * 2;
+						}
+						w -= code;
+						if (w < 0) {
+							code += w;
+						}
+						while (code--) {
+							oldWrite16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
+							dataPtr += 2;
+							dstPtr += dstInc;
+						}
+					}
+				}
+			}
+			dataPtr = dataPtrNext;
+			dstPtr = dstPtrNext;
+		}
+	}
+#endif
+
+	/**
+	 * The parts of the image to draw: all of it, clipped at each edge, and a
+	 * few pixels in the middle of the runs
+	 */
+	static Common::Array<Common::Rect> sampleRects() {
+		Common::Array<Common::Rect> rects;
+		rects.push_back(Common::Rect(kWidth, kHeight));
+		rects.push_back(Common::Rect(37, 0, kWidth, kHeight));
+		rects.push_back(Common::Rect(0, 9, 101, kHeight));
+		rects.push_back(Common::Rect(1, 1, kWidth - 1, kHeight - 1));
+		rects.push_back(Common::Rect(70, 15, 73, 16));
+		rects.push_back(Common::Rect(64, 5, 129, 30));
+		return rects;
+	}
+
+	/**
+	 * Draws the data with the decompressor and with the per-pixel version,
+	 * onto the same background, for every clipping rect, mirroring and
+	 * destination type. Nothing outside of the drawn area may change.
+	 */
+	template<typename Draw>
+	void checkDecompressor(const Draw &draw, int bitDepth) {
+		const Common::Array<Common::Rect> rects = sampleRects();
+		const int dstTypes[] = { Scumm::kDstScreen, Scumm::kDstMemory };
+		const int flags[] = { 0, Scumm::kWIFFlipX, Scumm::kWIFFlipY, Scumm::kWIFFlipX | Scumm::kWIFFlipY };
+
+		for (uint r = 0; r < rects.size(); ++r) {
+			for (int d = 0; d < (int)ARRAYSIZE(dstTypes); ++d) {
+				for (int f = 0; f < (int)ARRAYSIZE(flags); ++f) {
+					const Common::Rect &rect = rects[r];
+					const int pitch = (rect.width() + 2 * kPadding) * bitDepth;
+					Common::Array<byte> dst(pitch * (rect.height() + 2 * kPadding)), expected;
+					fill(dst);
+					expected = dst;
+
+					const int offset = kPadding * pitch + kPadding * bitDepth;
+					draw(&dst[offset], pitch, dstTypes[d], rect, flags[f], false);
+					draw(&expected[offset], pitch, dstTypes[d], rect, flags[f], true);
+
+					if (dst != expected) {
+						char buf[100];
+						snprintf(buf, sizeof(buf), "Mismatch for rect %u, destination type %d, flags %x", r, dstTypes[d], flags[f]);
+						TS_FAIL(buf);
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	template<int type>
+	struct Draw8 {
+		const byte *data;
+		const byte *palette;
+		const byte *xmap;
+		uint8 bitDepth;
+
+		void operator()(uint8 *dst, int pitch, int dstType, const Common::Rect &rect, int flags, bool old) const {
+			if (old)
+				oldDecompressWizImage<type>(dst, pitch, dstType, data, rect, flags, palette, xmap, bitDepth);
+			else
+				Scumm::Wiz::decompressWizImage<type>(dst, pitch, dstType, data, rect, flags, palette, xmap, bitDepth);
+		}
+	};
+
+	template<int type>
+	void check8(const Common::Array<byte> &data, const Common::Array<byte> &palette, const Common::Array<byte> &xmap, uint8 bitDepth) {
+		Draw8<type> draw;
+		draw.data = &data[0];
+		draw.palette = &palette[0];
+		draw.xmap = &xmap[0];
+		draw.bitDepth = bitDepth;
+		checkDecompressor(draw, bitDepth);
+	}
+
+#ifdef USE_RGB_COLOR
+	template<int type>
+	struct Draw16 {
+		const byte *data;
+		const byte *xmap;
+
+		void operator()(uint8 *dst, int pitch, int dstType, const Common::Rect &rect, int flags, bool old) const {
+			if (old)
+				oldDecompress16BitWizImage<type>(dst, pitch, dstType, data, rect, flags, xmap);
+			else
+				Scumm::Wiz::decompress16BitWizImage<type>(dst, pitch, dstType, data, rect, flags, xmap);
+		}
+	};
+#endif
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_decompress8() {
+		Common::Array<byte> pixels(kWidth * kHeight), data;
+		for (int y = 0; y < kHeight; ++y)
+			for (int x = 0; x < kWidth; ++x)
+				pixels[y * kWidth + x] = samplePixel(x, y);
+		encode8(pixels, data);
+
+
+		Common::Array<byte> palette(512), xmap(256 * 256);
+		fill(palette);
+		fill(xmap);
+
+		for (uint8 bitDepth = 1; bitDepth <= 2; ++bitDepth) {
+			check8<Scumm::kWizXMap>(data, palette, xmap, bitDepth);
+			check8<Scumm::kWizRMap>(data, palette, xmap, bitDepth);
+			check8<Scumm::kWizCopy>(data, palette, xmap, bitDepth);
+		}
+	}
+
+	void test_decompress16() {
+#ifdef USE_RGB_COLOR
+		Common::Array<uint16> pixels(kWidth * kHeight);
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 0; x < kWidth; ++x) {
+				const uint16 color = samplePixel(x, y);
+				// Spread the colors over all 16 bits, but keep the runs
+				pixels[y * kWidth + x] = color == kTransColor ? color : color * 0x0101 + 0x1000;
+			}
+		}
+		Common::Array<byte> data, xmap(256 * 256);
+		encode16(pixels, data);
+		fill(xmap);
+
+		Draw16<Scumm::kWizXMap> blend;
+		blend.data = &data[0];
+		blend.xmap = &xmap[0];
+		checkDecompressor(blend, 2);
+
+		Draw16<Scumm::kWizCopy> copy;
+		copy.data = &data[0];
+		copy.xmap = &xmap[0];
+		checkDecompressor(copy, 2);
+#endif
+	}
+};
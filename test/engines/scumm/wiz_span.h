@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+
+#include "engines/scumm/he/wiz_span_he.h"
+
+/**
+ * Compares the Wiz span kernels with drawing the same pixels one by one, the
+ * way the Wiz decompressors used to.
+ */
+class WizSpanTestSuite : public CxxTest::TestSuite {
+	enum {
+		kMaxCount = 77,
+		kPadding = 8
+	};
+
+	uint32 _seed;
+
+	byte nextByte() {
+		_seed = _seed * 1103515245 + 12345;
+		return (byte)(_seed >> 16);
+	}
+
+	void fill(Common::Array<byte> &data) {
+		for (uint i = 0; i < data.size(); ++i)
+			data[i] = nextByte();
+	}
+
+	static uint16 blend(uint16 src, uint16 dst) {
+		return ((src >> 1) & 0x7DEF) + ((dst >> 1) & 0x7DEF);
+	}
+
+public:
+	WizSpanTestSuite() : _seed(1) {}
+
+	void test_fill16() {
+		for (int count = 0; count <= kMaxCount; ++count) {
+			Common::Array<byte> dst(count * 2 + kPadding), expected;
+			fill(dst);
+			expected = dst;
+			const uint16 color = nextByte() | (nextByte() << 8);
+
+			// Unaligned on purpose
+			Scumm::wizSpanFill16(&dst[1], color, count);
+			for (int i = 0; i < count; ++i)
+				WRITE_LE_UINT16(&expected[1 + i * 2], color);
+			TS_ASSERT(dst == expected);
+		}
+	}
+
+	void test_blend16() {
+		for (int count = 0; count <= kMaxCount; ++count) {
+			Common::Array<byte> src(count * 2 + kPadding), dst(count * 2 + kPadding), expected;
+			fill(src);
+			fill(dst);
+			expected = dst;
+
+			Scumm::wizSpanBlend16(&dst[1], &src[3], count);
+			for (int i = 0; i < count; ++i)
+				WRITE_LE_UINT16(&expected[1 + i * 2], blend(READ_LE_UINT16(&src[3 + i * 2]), READ_LE_UINT16(&expected[1 + i * 2])));
+			TS_ASSERT(dst == expected);
+
+			const uint16 color = READ_LE_UINT16(&src[0]);
+			expected = dst;
+			Scumm::wizSpanBlendFill16(&dst[0], color, count);
+			for (int i = 0; i < count; ++i)
+				WRITE_LE_UINT16(&expected[i * 2], blend(color, READ_LE_UINT16(&expected[i * 2])));
+			TS_ASSERT(dst == expected);
+		}
+	}
+
+	void test_map8() {
+		Common::Array<byte> palette(256), xmap(256 * 256);
+		fill(palette);
+		fill(xmap);
+
+		for (int count = 0; count <= kMaxCount; ++count) {
+			Common::Array<byte> src(count + kPadding), dst(count + kPadding), expected;
+			fill(src);
+			fill(dst);
+
+			expected = dst;
+			Scumm::wizSpanRemap8(&dst[0], &src[0], &palette[0], count);
+			for (int i = 0; i < count; ++i)
+				expected[i] = palette[src[i]];
+			TS_ASSERT(dst == expected);
+
+			expected = dst;
+			Scumm::wizSpanXMap8(&dst[0], &src[0], &xmap[0], count);
+			for (int i = 0; i < count; ++i)
+				expected[i] = xmap[src[i] * 256 + expected[i]];
+			TS_ASSERT(dst == expected);
+
+			expected = dst;
+			Scumm::wizSpanXMapFill8(&dst[0], &xmap[src[0] * 256], count);
+			for (int i = 0; i < count; ++i)
+				expected[i] = xmap[src[0] * 256 + expected[i]];
+			TS_ASSERT(dst == expected);
+		}
+	}
+};
@@ -0,0 +1,66 @@
+#include <cxxtest/TestSuite.h>
+#include "engines/wintermute/base/scriptables/script_atoms.h"
+
+class ScAtomTableTestSuite : public CxxTest::TestSuite {
+public:
+	void test_intern() {
+		Wintermute::ScAtomTable atoms;
+		TS_ASSERT_EQUALS(atoms.size(), 0u);
+		TS_ASSERT_EQUALS(atoms.find("self"), (Wintermute::ScAtom)Wintermute::kScNoAtom);
+
+		Wintermute::ScAtom self = atoms.intern("self");
+		Wintermute::ScAtom game = atoms.intern("Game");
+		TS_ASSERT_DIFFERS(self, (Wintermute::ScAtom)Wintermute::kScNoAtom);
+		TS_ASSERT_DIFFERS(self, game);
+		TS_ASSERT_EQUALS(atoms.intern("self"), self);
+		TS_ASSERT_EQUALS(atoms.find("Game"), game);
+		TS_ASSERT_EQUALS(atoms.size(), 2u);
+
+		// Script identifiers are case sensitive
+		TS_ASSERT_DIFFERS(atoms.intern("game"), game);
+	}
+
+	void test_names_stay_valid() {
+		Wintermute::ScAtomTable atoms;
+		Wintermute::ScAtom first = atoms.intern("first");
+		const Common::String &name = atoms.getName(first);
+
+		// Growing the table must not move the names handed out before
+		for (int i = 0; i < 1000; i++) {
+			atoms.intern(Common::String::format("var%d", i).c_str());
+		}
+		TS_ASSERT_EQUALS(name, "first");
+		TS_ASSERT_EQUALS(&atoms.getName(first), &name);
+		TS_ASSERT_EQUALS(atoms.getName(atoms.find("var999")), "var999");
+	}
+
+	void test_release() {
+		Wintermute::ScAtomTable atoms;
+		Wintermute::ScAtom index = atoms.intern("42");
+		atoms.addRef(index);
+		TS_ASSERT_EQUALS(atoms.intern("42"), index);
+		TS_ASSERT_EQUALS(atoms.getRefCount(index), 3u);
+
+		atoms.release(index);
+		atoms.release(index);
+		TS_ASSERT_EQUALS(atoms.find("42"), index);
+		atoms.release(index);
+		TS_ASSERT_EQUALS(atoms.find("42"), (Wintermute::ScAtom)Wintermute::kScNoAtom);
+		TS_ASSERT_EQUALS(atoms.size(), 0u);
+
+		// Unknown and dead atoms are ignored
+		atoms.release(index);
+		atoms.release(12345);
+		atoms.release(Wintermute::kScNoAtom);
+		TS_ASSERT_EQUALS(atoms.getRefCount(index), 0u);
+
+		// Freed atoms are reused, so dynamic keys don't grow the table
+		for (int i = 0; i < 1000; i++) {
+			Wintermute::ScAtom atom = atoms.intern(Common::String::format("%d", i).c_str());
+			TS_ASSERT_EQUALS(atom, index);
+			TS_ASSERT_EQUALS(atoms.getName(atom), Common::String::format("%d", i));
+			atoms.release(atom);
+		}
+		TS_ASSERT_EQUALS(atoms.size(), 0u);
+	}
+};
@@ -0,0 +1,208 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_region.h"
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+
+#include "test/benchmark.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 640,
+		kHeight = 480
+	};
+
+	uint32 _seed;
+
+	int nextRandom(int max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	Common::Rect randomRect(int maxSize) {
+		const int x = nextRandom(kWidth + 40) - 20;
+		const int y = nextRandom(kHeight + 40) - 20;
+		return Common::Rect(x, y, x + 1 + nextRandom(maxSize), y + 1 + nextRandom(maxSize));
+	}
+
+	/**
+	 * The list based merging Graphics::Screen used before, for comparison
+	 */
+	static void mergeRects(Common::List<Common::Rect> &rects) {
+		Common::List<Common::Rect>::iterator rOuter, rInner;
+		for (rOuter = rects.begin(); rOuter != rects.end(); ++rOuter) {
+			rInner = rOuter;
+			while (++rInner != rects.end()) {
+				if ((*rOuter).intersects(*rInner)) {
+					(*rOuter).extend(*rInner);
+					rects.erase(rInner);
+					rInner = rOuter;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Checks that the rects don't overlap, cover every pixel of the input
+	 * and nothing outside of the tiles the input touches.
+	 */
+	void checkRects(const Common::Array<Common::Rect> &input, const Common::Array<Common::Rect> &output) {
+		Common::Array<byte> expected(kWidth * kHeight, 0), covered(kWidth * kHeight, 0), tiles(kWidth * kHeight, 0);
+		const Common::Rect bounds(kWidth, kHeight);
+
+		for (uint i = 0; i < input.size(); ++i) {
+			Common::Rect r = input[i];
+			r.clip(bounds);
+			if (r.isEmpty())
+				continue;
+			for (int y = r.top; y < r.bottom; ++y)
+				for (int x = r.left; x < r.right; ++x)
+					expected[y * kWidth + x] = 1;
+
+			const int tileSize = Graphics::DirtyRegion::kTileSize;
+			Common::Rect t(r.left / tileSize * tileSize, r.top / tileSize * tileSize,
+			               (r.right + tileSize - 1) / tileSize * tileSize, (r.bottom + tileSize - 1) / tileSize * tileSize);
+			t.clip(bounds);
+			for (int y = t.top; y < t.bottom; ++y)
+				for (int x = t.left; x < t.right; ++x)
+					tiles[y * kWidth + x] = 1;
+		}
+
+		for (uint i = 0; i < output.size(); ++i) {
+			const Common::Rect &r = output[i];
+			TS_ASSERT(!r.isEmpty());
+			TS_ASSERT(bounds.contains(r));
+			for (int y = r.top; y < r.bottom; ++y) {
+				for (int x = r.left; x < r.right; ++x) {
+					if (covered[y * kWidth + x]++) {
+						TS_FAIL("Overlapping rects");
+						return;
+					}
+				}
+			}
+		}
+
+		for (uint i = 0; i < expected.size(); ++i) {
+			if ((expected[i] && !covered[i]) || (covered[i] && !tiles[i])) {
+				TS_FAIL("Rects don't match the dirty tiles");
+				return;
+			}
+		}
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_empty() {
+		Graphics::DirtyRegion region(kWidth, kHeight);
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(-20, -20, -1, -1));
+		region.addRect(Common::Rect(kWidth, 0, kWidth + 10, 10));
+		TS_ASSERT(region.isEmpty());
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		TS_ASSERT(rects.empty());
+	}
+
+	void test_coalescing() {
+		Graphics::DirtyRegion region(kWidth, kHeight);
+		region.markAllDirty();
+		TS_ASSERT(!region.isEmpty());
+
+		// A fully dirty area gives a single rect
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT(rects[0] == Common::Rect(kWidth, kHeight));
+
+		// So do many small rects next to each other
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+		for (int y = 100; y < 200; y += 5)
+			for (int x = 33; x < 300; x += 7)
+				region.addRect(Common::Rect(x, y, x + 7, y + 5));
+		rects.clear();
+		region.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT(rects[0] == Common::Rect(32, 96, 320, 208));
+
+		// Clipping at the edges of an area which isn't a multiple of the tile size
+		Graphics::DirtyRegion odd(kWidth - 3, kHeight - 5);
+		odd.addRect(Common::Rect(kWidth - 10, kHeight - 10, kWidth, kHeight));
+		rects.clear();
+		odd.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1u);
+		TS_ASSERT(rects[0] == Common::Rect(kWidth - 16, kHeight - 16, kWidth - 3, kHeight - 5));
+	}
+
+	void test_nextRandom() {
+		Graphics::DirtyRegion region(kWidth, kHeight);
+		for (int round = 0; round < 20; ++round) {
+			Common::Array<Common::Rect> input, output;
+			const int count = 1 + nextRandom(300);
+			for (int i = 0; i < count; ++i) {
+				input.push_back(randomRect(round & 1 ? 200 : 30));
+				region.addRect(input.back());
+			}
+
+			region.getRects(output);
+			checkRects(input, output);
+			region.clear();
+		}
+	}
+
+	/**
+	 * Micro-benchmark comparing the tile tracking against the list merging,
+	 * for a frame with many small sprites.
+	 */
+	void test_benchmark() {
+		enum {
+			kFrames = 50,
+			kSprites = 400
+		};
+
+		Common::Array<Common::Rect> frame;
+		for (int i = 0; i < kSprites; ++i)
+			frame.push_back(randomRect(24));
+
+		BenchmarkTimer timer;
+		uint listRects = 0;
+		for (int f = 0; f < kFrames; ++f) {
+			Common::List<Common::Rect> list;
+			for (uint i = 0; i < frame.size(); ++i) {
+				Common::Rect r = frame[i];
+				r.clip(Common::Rect(kWidth, kHeight));
+				if (!r.isEmpty())
+					list.push_back(r);
+			}
+			mergeRects(list);
+			listRects = list.size();
+		}
+		const double listTime = timer.seconds();
+
+		timer.restart();
+		uint tileRects = 0;
+		Graphics::DirtyRegion region(kWidth, kHeight);
+		Common::Array<Common::Rect> rects;
+		for (int f = 0; f < kFrames; ++f) {
+			for (uint i = 0; i < frame.size(); ++i)
+				region.addRect(frame[i]);
+			rects.clear();
+			region.getRects(rects);
+			region.clear();
+			tileRects = rects.size();
+		}
+		const double tileTime = timer.seconds();
+
+		char buf[160];
+		snprintf(buf, sizeof(buf), "%d sprites: list merging %u rects, %.3f ms/frame; tiles %u rects, %.3f ms/frame",
+		         (int)kSprites, listRects, listTime * 1000 / kFrames, tileRects, tileTime * 1000 / kFrames);
+		TS_TRACE(buf);
+	}
+};